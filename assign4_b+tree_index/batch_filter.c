@@ -0,0 +1,699 @@
+#include "stdlib.h"
+#include "string.h"
+#include "pthread.h"
+#include "batch_filter.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FILTER_X86 1
+#include "immintrin.h"
+#endif
+
+/*Comparison kernels over the columns of a RecordBatch.
+	A kernel compares every row of one column with a constant and sets the bit of each row that
+	satisfies OP_COMP_EQUAL or OP_COMP_SMALLER in a selection bitmap. Conditions made of such
+	comparisons are evaluated by combining bitmaps with OP_BOOL_AND, OP_BOOL_OR and OP_BOOL_NOT.
+	Every kernel has a scalar version and, on x86, SSE2 and AVX2 versions compiled with target
+	attributes; the set to use is chosen once from what the processor supports.
+	The results are those of evalExpr on each row.*/
+
+//Bytes of a string constant beyond the attribute length, vector loads may read up to a register past the end.
+#define CONSTANT_PADDING 32
+
+//Compares numRows values of a column with a constant in column layout, sets the bits of the satisfying rows.
+typedef void (*CompareKernel) (char *column, int numRows, char *constant, int width, uint64_t *bits);
+
+//Kernels of one instruction set
+typedef struct FilterKernels
+{
+	CompareKernel eqInt, ltInt;
+	CompareKernel eqFloat, ltFloat;
+	CompareKernel eqBool, ltBool;
+	CompareKernel eqString, ltString;
+}
+FilterKernels;
+
+/*
+ * SCALAR KERNELS
+ * Numeric columns hold values of their own size, only the string kernels use the width.
+*/
+
+#define SCALAR_KERNEL(name, type, test)										\
+static void name (char *column, int numRows, char *constant, int width, uint64_t *bits)		\
+{															\
+	type *values = (type *) column;												\
+	type k = *(type *) constant;												\
+	int row;														\
+	(void) width;														\
+	for(row = 0; row < numRows; row++)											\
+		bits[row >> 6] |= (uint64_t) (test) << (row & 63);							\
+}
+
+SCALAR_KERNEL(eqIntScalar, int, values[row] == k)
+SCALAR_KERNEL(ltIntScalar, int, values[row] < k)
+SCALAR_KERNEL(eqFloatScalar, float, values[row] == k)
+SCALAR_KERNEL(ltFloatScalar, float, values[row] < k)
+SCALAR_KERNEL(eqBoolScalar, bool, values[row] == k)
+SCALAR_KERNEL(ltBoolScalar, bool, values[row] < k)
+
+/*
+ * Function: eqStringScalar / ltStringScalar
+ * ---------------------------
+ * String attributes are width characters, terminated early by a '\0' if shorter, which is how
+ * getAttr reads them; strncmp compares them the way strcmp compares the values of getAttr.
+ *
+ */
+
+static void eqStringScalar (char *column, int numRows, char *constant, int width, uint64_t *bits)
+{
+	int row;
+	for(row = 0; row < numRows; row++)
+		bits[row >> 6] |= (uint64_t) (strncmp(column + (size_t) row * width, constant, width) == 0) << (row & 63);
+}
+
+static void ltStringScalar (char *column, int numRows, char *constant, int width, uint64_t *bits)
+{
+	int row;
+	for(row = 0; row < numRows; row++)
+		bits[row >> 6] |= (uint64_t) (strncmp(column + (size_t) row * width, constant, width) < 0) << (row & 63);
+}
+
+static FilterKernels scalarKernels = {
+	eqIntScalar, ltIntScalar,
+	eqFloatScalar, ltFloatScalar,
+	eqBoolScalar, ltBoolScalar,
+	eqStringScalar, ltStringScalar
+};
+
+#ifdef FILTER_X86
+
+/*
+ * SSE2 KERNELS
+ * The rows a full register does not cover are compared one at a time.
+*/
+
+#define SSE2_KERNEL(name, type, lanes, test, compare)							\
+__attribute__((target("sse2")))												\
+static void name (char *column, int numRows, char *constant, int width, uint64_t *bits)		\
+{															\
+	type *values = (type *) column;												\
+	type k = *(type *) constant;												\
+	int row;														\
+	(void) width;														\
+	int whole = numRows - numRows % lanes;										\
+	for(row = 0; row < whole; row += lanes)										\
+	{															\
+		__m128i v = _mm_loadu_si128((__m128i *) (values + row));						\
+		bits[row >> 6] |= (uint64_t) (compare) << (row & 63);							\
+	}															\
+	for(; row < numRows; row++)												\
+		bits[row >> 6] |= (uint64_t) (test) << (row & 63);							\
+}
+
+SSE2_KERNEL(eqIntSse2, int, 4, values[row] == k,
+		_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, _mm_set1_epi32(k)))))
+SSE2_KERNEL(ltIntSse2, int, 4, values[row] < k,
+		_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, _mm_set1_epi32(k)))))
+SSE2_KERNEL(eqFloatSse2, float, 4, values[row] == k,
+		_mm_movemask_ps(_mm_cmpeq_ps(_mm_castsi128_ps(v), _mm_set1_ps(k))))
+SSE2_KERNEL(ltFloatSse2, float, 4, values[row] < k,
+		_mm_movemask_ps(_mm_cmplt_ps(_mm_castsi128_ps(v), _mm_set1_ps(k))))
+SSE2_KERNEL(eqBoolSse2, bool, 8, values[row] == k,
+		_mm_movemask_epi8(_mm_packs_epi16(_mm_cmpeq_epi16(v, _mm_set1_epi16(k)), _mm_setzero_si128())))
+SSE2_KERNEL(ltBoolSse2, bool, 8, values[row] < k,
+		_mm_movemask_epi8(_mm_packs_epi16(_mm_cmplt_epi16(v, _mm_set1_epi16(k)), _mm_setzero_si128())))
+
+/*
+ * Function: compareStringSse2
+ * ---------------------------
+ * This function is strncmp(field, constant, width) 16 characters at a time: it stops at the first
+ * character that differs from the constant or ends the field.
+ *
+ * field: the string attribute of a row, readable up to 16 bytes past width.
+ * constant: the constant, padded with '\0' to 16 bytes past width.
+ * width: the attribute length.
+ *
+ * returns : <0, 0 or >0 like strncmp.
+ *
+ */
+
+__attribute__((target("sse2")))
+static inline int compareStringSse2 (char *field, char *constant, int width)
+{
+	int pos, stop;
+
+	for(pos = 0; pos < width; pos += 16)
+	{
+		__m128i f = _mm_loadu_si128((__m128i *) (field + pos));
+		__m128i c = _mm_loadu_si128((__m128i *) (constant + pos));
+		stop = (~_mm_movemask_epi8(_mm_cmpeq_epi8(f, c)) | _mm_movemask_epi8(_mm_cmpeq_epi8(f, _mm_setzero_si128()))) & 0xFFFF;
+		if(width - pos < 16)
+		{
+			stop &= (1 << (width - pos)) - 1;
+		}
+		if(stop != 0)
+		{
+			pos += __builtin_ctz(stop);
+			return (unsigned char) field[pos] - (unsigned char) constant[pos];
+		}
+	}
+	return 0;
+}
+
+__attribute__((target("sse2")))
+static void eqStringSse2 (char *column, int numRows, char *constant, int width, uint64_t *bits)
+{
+	int row;
+	for(row = 0; row < numRows; row++)
+		bits[row >> 6] |= (uint64_t) (compareStringSse2(column + (size_t) row * width, constant, width) == 0) << (row & 63);
+}
+
+__attribute__((target("sse2")))
+static void ltStringSse2 (char *column, int numRows, char *constant, int width, uint64_t *bits)
+{
+	int row;
+	for(row = 0; row < numRows; row++)
+		bits[row >> 6] |= (uint64_t) (compareStringSse2(column + (size_t) row * width, constant, width) < 0) << (row & 63);
+}
+
+static FilterKernels sse2Kernels = {
+	eqIntSse2, ltIntSse2,
+	eqFloatSse2, ltFloatSse2,
+	eqBoolSse2, ltBoolSse2,
+	eqStringSse2, ltStringSse2
+};
+
+/*
+ * AVX2 KERNELS
+*/
+
+#define AVX2_KERNEL(name, type, lanes, test, compare)							\
+__attribute__((target("avx2")))												\
+static void name (char *column, int numRows, char *constant, int width, uint64_t *bits)		\
+{															\
+	type *values = (type *) column;												\
+	type k = *(type *) constant;												\
+	int row;														\
+	(void) width;														\
+	int whole = numRows - numRows % lanes;										\
+	for(row = 0; row < whole; row += lanes)										\
+	{															\
+		__m256i v = _mm256_loadu_si256((__m256i *) (values + row));						\
+		bits[row >> 6] |= (uint64_t) (compare) << (row & 63);							\
+	}															\
+	for(; row < numRows; row++)												\
+		bits[row >> 6] |= (uint64_t) (test) << (row & 63);							\
+}
+
+//16 bit lane mask of a 16 x 16 bit comparison, the packed halves keep the rows in order
+#define MASK_EPI16(cmp) _mm_movemask_epi8(_mm_packs_epi16(_mm256_castsi256_si128(cmp), _mm256_extracti128_si256(cmp, 1)))
+
+AVX2_KERNEL(eqIntAvx2, int, 8, values[row] == k,
+		_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, _mm256_set1_epi32(k)))))
+AVX2_KERNEL(ltIntAvx2, int, 8, values[row] < k,
+		_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(k), v))))
+AVX2_KERNEL(eqFloatAvx2, float, 8, values[row] == k,
+		_mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_set1_ps(k), _CMP_EQ_OQ)))
+AVX2_KERNEL(ltFloatAvx2, float, 8, values[row] < k,
+		_mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_set1_ps(k), _CMP_LT_OQ)))
+AVX2_KERNEL(eqBoolAvx2, bool, 16, values[row] == k,
+		MASK_EPI16(_mm256_cmpeq_epi16(v, _mm256_set1_epi16(k))))
+AVX2_KERNEL(ltBoolAvx2, bool, 16, values[row] < k,
+		MASK_EPI16(_mm256_cmpgt_epi16(_mm256_set1_epi16(k), v)))
+
+/*
+ * Function: compareStringAvx2
+ * ---------------------------
+ * compareStringSse2 32 characters at a time.
+ *
+ */
+
+__attribute__((target("avx2")))
+static inline int compareStringAvx2 (char *field, char *constant, int width)
+{
+	int pos;
+	unsigned int stop;
+
+	for(pos = 0; pos < width; pos += 32)
+	{
+		__m256i f = _mm256_loadu_si256((__m256i *) (field + pos));
+		__m256i c = _mm256_loadu_si256((__m256i *) (constant + pos));
+		stop = ~(unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(f, c)) | (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(f, _mm256_setzero_si256()));
+		if(width - pos < 32)
+		{
+			stop &= (1u << (width - pos)) - 1;
+		}
+		if(stop != 0)
+		{
+			pos += __builtin_ctz(stop);
+			return (unsigned char) field[pos] - (unsigned char) constant[pos];
+		}
+	}
+	return 0;
+}
+
+__attribute__((target("avx2")))
+static void eqStringAvx2 (char *column, int numRows, char *constant, int width, uint64_t *bits)
+{
+	int row;
+	for(row = 0; row < numRows; row++)
+		bits[row >> 6] |= (uint64_t) (compareStringAvx2(column + (size_t) row * width, constant, width) == 0) << (row & 63);
+}
+
+__attribute__((target("avx2")))
+static void ltStringAvx2 (char *column, int numRows, char *constant, int width, uint64_t *bits)
+{
+	int row;
+	for(row = 0; row < numRows; row++)
+		bits[row >> 6] |= (uint64_t) (compareStringAvx2(column + (size_t) row * width, constant, width) < 0) << (row & 63);
+}
+
+static FilterKernels avx2Kernels = {
+	eqIntAvx2, ltIntAvx2,
+	eqFloatAvx2, ltFloatAvx2,
+	eqBoolAvx2, ltBoolAvx2,
+	eqStringAvx2, ltStringAvx2
+};
+
+#endif // FILTER_X86
+
+/*
+ * KERNEL SELECTION
+*/
+
+static pthread_once_t detectOnce = PTHREAD_ONCE_INIT;
+static RM_FilterLevel supportedLevel = RM_FILTER_SCALAR;
+static RM_FilterLevel currentLevel = RM_FILTER_SCALAR;
+static FilterKernels *kernels = &scalarKernels;
+
+/*
+ * Function: useLevel
+ * ---------------------------
+ * This function switches to the kernels of an instruction set.
+ *
+ * level: the instruction set, supported by the processor.
+ *
+ * returns : void
+ *
+ */
+
+static void useLevel (RM_FilterLevel level)
+{
+	currentLevel = level;
+#ifdef FILTER_X86
+	if(level == RM_FILTER_AVX2)
+	{
+		kernels = &avx2Kernels;
+		return;
+	}
+	if(level == RM_FILTER_SSE2)
+	{
+		kernels = &sse2Kernels;
+		return;
+	}
+#endif
+	kernels = &scalarKernels;
+}
+
+/*
+ * Function: detectLevel
+ * ---------------------------
+ * This function picks the best instruction set the processor supports, once per process.
+ * The vector bool kernels compare 16 bit lanes, so they need the 16 bit bool of dt.h.
+ *
+ * returns : void
+ *
+ */
+
+static void detectLevel (void)
+{
+	supportedLevel = RM_FILTER_SCALAR;
+#ifdef FILTER_X86
+	__builtin_cpu_init();
+	if(sizeof(bool) == 2 && __builtin_cpu_supports("sse2"))
+	{
+		supportedLevel = RM_FILTER_SSE2;
+	}
+	if(supportedLevel == RM_FILTER_SSE2 && __builtin_cpu_supports("avx2"))
+	{
+		supportedLevel = RM_FILTER_AVX2;
+	}
+#endif
+	useLevel(supportedLevel);
+}
+
+/*
+ * Function: getFilterLevel
+ * ---------------------------
+ * This function returns the instruction set of the kernels in use.
+ *
+ * returns : the level.
+ *
+ */
+
+RM_FilterLevel getFilterLevel (void)
+{
+	pthread_once(&detectOnce, detectLevel);
+	return currentLevel;
+}
+
+/*
+ * Function: setFilterLevel
+ * ---------------------------
+ * This function restricts the kernels to an instruction set, to compare the kernels of
+ * different levels. Levels the processor does not support fall back to the best supported one.
+ * Call it while no batch is being filtered.
+ *
+ * level: the instruction set.
+ *
+ * returns : the level in use afterwards.
+ *
+ */
+
+RM_FilterLevel setFilterLevel (RM_FilterLevel level)
+{
+	pthread_once(&detectOnce, detectLevel);
+	useLevel((level < supportedLevel) ? level : supportedLevel);
+	return currentLevel;
+}
+
+/*
+ * BITMAPS
+*/
+
+/*
+ * Function: andBitmaps / orBitmaps
+ * ---------------------------
+ * These functions combine a bitmap with another one for OP_BOOL_AND and OP_BOOL_OR.
+ *
+ * bits: the bitmap, receives the result.
+ * other: the other bitmap.
+ * numRows: rows of the bitmaps.
+ *
+ * returns : void
+ *
+ */
+
+void andBitmaps (uint64_t *bits, uint64_t *other, int numRows)
+{
+	int word;
+	for(word = 0; word < BITMAP_WORDS(numRows); word++)
+		bits[word] &= other[word];
+}
+
+void orBitmaps (uint64_t *bits, uint64_t *other, int numRows)
+{
+	int word;
+	for(word = 0; word < BITMAP_WORDS(numRows); word++)
+		bits[word] |= other[word];
+}
+
+/*
+ * Function: notBitmap
+ * ---------------------------
+ * This function inverts a bitmap for OP_BOOL_NOT. Bits past the last row stay clear.
+ *
+ * bits: the bitmap.
+ * numRows: rows of the bitmap.
+ *
+ * returns : void
+ *
+ */
+
+void notBitmap (uint64_t *bits, int numRows)
+{
+	int word;
+	for(word = 0; word < BITMAP_WORDS(numRows); word++)
+		bits[word] = ~bits[word];
+	if(numRows % 64 != 0)
+	{
+		bits[numRows / 64] &= ((uint64_t) 1 << (numRows % 64)) - 1;
+	}
+}
+
+/*
+ * Function: bitmapToSelection
+ * ---------------------------
+ * This function lists the rows whose bit is set.
+ *
+ * bits: the bitmap.
+ * numRows: rows of the bitmap.
+ * sel: Receives the rows in ascending order, room for numRows.
+ *
+ * returns : the number of rows listed.
+ *
+ */
+
+int bitmapToSelection (uint64_t *bits, int numRows, int *sel)
+{
+	int numSelected = 0;
+	int word;
+	uint64_t set;
+
+	for(word = 0; word < BITMAP_WORDS(numRows); word++)
+	{
+		for(set = bits[word]; set != 0; set &= set - 1)
+		{
+			sel[numSelected++] = word * 64 + __builtin_ctzll(set);
+		}
+	}
+	return numSelected;
+}
+
+/*
+ * COLUMNS AND CONDITIONS
+*/
+
+/*
+ * Function: filterColumn
+ * ---------------------------
+ * This function compares every row of a column of a batch with a constant.
+ *
+ * batch: the batch, see nextBatch.
+ * attrNum: the attribute.
+ * op: OP_COMP_EQUAL or OP_COMP_SMALLER, the row is the left operand.
+ * constant: the constant, of the type of the attribute.
+ * bits: Receives the rows that satisfy the comparison, BITMAP_WORDS(batch->numRows) words.
+ *
+ * returns : RC_OK if the column was compared.
+ *			 RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE if the constant has another type.
+ *			 RC_RM_FILTER_NOT_SUPPORTED for other operators or attributes.
+ *
+ */
+
+RC filterColumn (RecordBatch *batch, int attrNum, OpType op, Value *constant, uint64_t *bits)
+{
+	Schema *schema = batch->schema;
+	char *column;
+	char *padded;
+	uint64_t *equal;
+	int width, length;
+
+	if(attrNum < 0 || attrNum >= schema->numAttr || (op != OP_COMP_EQUAL && op != OP_COMP_SMALLER))
+	{
+		return RC_RM_FILTER_NOT_SUPPORTED;
+	}
+	if(constant->dt != schema->dataTypes[attrNum])
+	{
+		return RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE;
+	}
+	pthread_once(&detectOnce, detectLevel);
+	memset(bits, 0, BITMAP_WORDS(batch->numRows) * sizeof(uint64_t));
+	column = batch->columns[attrNum];
+
+	switch(constant->dt)
+	{
+	case DT_INT:
+		((op == OP_COMP_EQUAL) ? kernels->eqInt : kernels->ltInt)(column, batch->numRows, (char *) &constant->v.intV, sizeof(int), bits);
+		break;
+	case DT_FLOAT:
+		((op == OP_COMP_EQUAL) ? kernels->eqFloat : kernels->ltFloat)(column, batch->numRows, (char *) &constant->v.floatV, sizeof(float), bits);
+		break;
+	case DT_BOOL:
+		((op == OP_COMP_EQUAL) ? kernels->eqBool : kernels->ltBool)(column, batch->numRows, (char *) &constant->v.boolV, sizeof(bool), bits);
+		break;
+	case DT_STRING:
+		//the kernels see the first width characters of the constant; a longer constant equals no row
+		//and is greater than the rows that equal its first width characters
+		width = schema->typeLength[attrNum];
+		length = strlen(constant->v.stringV);
+		padded = (char *) calloc(width + CONSTANT_PADDING, 1);
+		memcpy(padded, constant->v.stringV, (length < width) ? length : width);
+		if(op == OP_COMP_SMALLER)
+		{
+			kernels->ltString(column, batch->numRows, padded, width, bits);
+		}
+		if(length > width && op == OP_COMP_SMALLER)
+		{
+			equal = (uint64_t *) calloc(BITMAP_WORDS(batch->numRows), sizeof(uint64_t));
+			kernels->eqString(column, batch->numRows, padded, width, equal);
+			orBitmaps(bits, equal, batch->numRows);
+			free(equal);
+		}
+		if(length <= width && op == OP_COMP_EQUAL)
+		{
+			kernels->eqString(column, batch->numRows, padded, width, bits);
+		}
+		free(padded);
+		break;
+	}
+	return RC_OK;
+}
+
+/*
+ * Function: isPredicate
+ * ---------------------------
+ * This method checks that an expression is boolean and built from what the kernels evaluate:
+ * comparisons of an attribute with a constant of its type, bool attributes and constants,
+ * and OP_BOOL_AND, OP_BOOL_OR and OP_BOOL_NOT over those.
+ *
+ * expr: the expression.
+ * schema: schema of the rows.
+ *
+ * returns : TRUE if filterBatch can evaluate the expression.
+ *
+ */
+
+static bool isPredicate (Expr *expr, Schema *schema)
+{
+	Expr *attr, *cons;
+
+	switch(expr->type)
+	{
+	case EXPR_CONST:
+		return expr->expr.cons->dt == DT_BOOL;
+	case EXPR_ATTRREF:
+		return expr->expr.attrRef >= 0 && expr->expr.attrRef < schema->numAttr && schema->dataTypes[expr->expr.attrRef] == DT_BOOL;
+	case EXPR_OP:
+		switch(expr->expr.op->type)
+		{
+		case OP_BOOL_AND:
+		case OP_BOOL_OR:
+			return isPredicate(expr->expr.op->args[0], schema) && isPredicate(expr->expr.op->args[1], schema);
+		case OP_BOOL_NOT:
+			return isPredicate(expr->expr.op->args[0], schema);
+		case OP_COMP_EQUAL:
+		case OP_COMP_SMALLER:
+			attr = expr->expr.op->args[0];
+			cons = expr->expr.op->args[1];
+			//equality is symmetric, constant < attribute has no kernel
+			if(expr->expr.op->type == OP_COMP_EQUAL && attr->type == EXPR_CONST)
+			{
+				attr = expr->expr.op->args[1];
+				cons = expr->expr.op->args[0];
+			}
+			return attr->type == EXPR_ATTRREF && cons->type == EXPR_CONST
+					&& attr->expr.attrRef >= 0 && attr->expr.attrRef < schema->numAttr
+					&& schema->dataTypes[attr->expr.attrRef] == cons->expr.cons->dt;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Function: evalPredicate
+ * ---------------------------
+ * This function evaluates an expression accepted by isPredicate over all rows of a batch.
+ *
+ * batch: the batch.
+ * expr: the expression.
+ * bits: Receives the rows that satisfy the expression.
+ *
+ * returns : RC_OK
+ *
+ */
+
+static RC evalPredicate (RecordBatch *batch, Expr *expr, uint64_t *bits)
+{
+	Operator *op;
+	uint64_t *other;
+	Value falseValue;
+
+	switch(expr->type)
+	{
+	case EXPR_CONST:
+		memset(bits, 0, BITMAP_WORDS(batch->numRows) * sizeof(uint64_t));
+		if(expr->expr.cons->v.boolV)
+		{
+			notBitmap(bits, batch->numRows);
+		}
+		return RC_OK;
+	case EXPR_ATTRREF:
+		falseValue.dt = DT_BOOL;
+		falseValue.v.boolV = FALSE;
+		filterColumn(batch, expr->expr.attrRef, OP_COMP_EQUAL, &falseValue, bits);
+		notBitmap(bits, batch->numRows);
+		return RC_OK;
+	case EXPR_OP:
+		op = expr->expr.op;
+		switch(op->type)
+		{
+		case OP_BOOL_AND:
+		case OP_BOOL_OR:
+			evalPredicate(batch, op->args[0], bits);
+			other = (uint64_t *) malloc(BITMAP_WORDS(batch->numRows) * sizeof(uint64_t));
+			evalPredicate(batch, op->args[1], other);
+			if(op->type == OP_BOOL_AND)
+				andBitmaps(bits, other, batch->numRows);
+			else
+				orBitmaps(bits, other, batch->numRows);
+			free(other);
+			return RC_OK;
+		case OP_BOOL_NOT:
+			evalPredicate(batch, op->args[0], bits);
+			notBitmap(bits, batch->numRows);
+			return RC_OK;
+		case OP_COMP_EQUAL:
+		case OP_COMP_SMALLER:
+			if(op->args[0]->type == EXPR_ATTRREF)
+				return filterColumn(batch, op->args[0]->expr.attrRef, op->type, op->args[1]->expr.cons, bits);
+			return filterColumn(batch, op->args[1]->expr.attrRef, op->type, op->args[0]->expr.cons, bits);
+		}
+	}
+	return RC_RM_FILTER_NOT_SUPPORTED;
+}
+
+/*
+ * Function: canFilterBatch
+ * ---------------------------
+ * This function checks whether filterBatch can evaluate a scan condition.
+ *
+ * cond: the condition.
+ * schema: schema of the scanned table.
+ *
+ * returns : TRUE if the condition can be evaluated on the columns of a batch.
+ *
+ */
+
+bool canFilterBatch (Expr *cond, Schema *schema)
+{
+	return cond != NULL && isPredicate(cond, schema);
+}
+
+/*
+ * Function: filterBatch
+ * ---------------------------
+ * This function evaluates a condition on the columns of a batch and sets its selection vector
+ * to the rows that satisfy it.
+ *
+ * batch: the batch, numRows rows are evaluated.
+ * cond: the condition.
+ *
+ * returns : RC_OK if the selection vector was set.
+ *			 RC_RM_FILTER_NOT_SUPPORTED if canFilterBatch rejects the condition.
+ *
+ */
+
+RC filterBatch (RecordBatch *batch, Expr *cond)
+{
+	uint64_t *bits;
+
+	if(!canFilterBatch(cond, batch->schema))
+	{
+		return RC_RM_FILTER_NOT_SUPPORTED;
+	}
+	bits = (uint64_t *) malloc(BITMAP_WORDS(batch->numRows) * sizeof(uint64_t));
+	evalPredicate(batch, cond, bits);
+	batch->numSelected = bitmapToSelection(bits, batch->numRows, batch->sel);
+	free(bits);
+	return RC_OK;
+}
@@ -0,0 +1,34 @@
+#ifndef BATCH_FILTER_H
+#define BATCH_FILTER_H
+
+#include "stdint.h"
+#include "dberror.h"
+#include "expr.h"
+#include "record_mgr.h"
+
+// Instruction sets of the comparison kernels, the best one the processor supports is chosen at startup
+typedef enum RM_FilterLevel {
+	RM_FILTER_SCALAR = 0,
+	RM_FILTER_SSE2 = 1,
+	RM_FILTER_AVX2 = 2
+} RM_FilterLevel;
+
+// Words of a selection bitmap over rows, bit r % 64 of word r / 64 is set if row r is selected
+#define BITMAP_WORDS(rows) (((rows) + 63) / 64)
+
+// kernel selection
+extern RM_FilterLevel getFilterLevel (void);
+extern RM_FilterLevel setFilterLevel (RM_FilterLevel level);
+
+// column kernels and bitmaps
+extern RC filterColumn (RecordBatch *batch, int attrNum, OpType op, Value *constant, uint64_t *bits);
+extern void andBitmaps (uint64_t *bits, uint64_t *other, int numRows);
+extern void orBitmaps (uint64_t *bits, uint64_t *other, int numRows);
+extern void notBitmap (uint64_t *bits, int numRows);
+extern int bitmapToSelection (uint64_t *bits, int numRows, int *sel);
+
+// conditions
+extern bool canFilterBatch (Expr *cond, Schema *schema);
+extern RC filterBatch (RecordBatch *batch, Expr *cond);
+
+#endif // BATCH_FILTER_H
@@ -29,6 +29,43 @@ BTree **bTreeCreate;
 int numOfKeys;
 int scanNextEntry;
 
+/*
+ * Function: pinNode
+ * ---------------------------
+ * This function pins a node page into the tree's page handle. The root is pinned as hot,
+ * so a burst of data page misses cannot evict it; leaves are pinned as normal pages,
+ * they are touched once per key and would only crowd the root out.
+ *
+ * treeInfo: Management structure for BTree Representation.
+ * pageNum: Page of the node, page 0 holds the root.
+ *
+ * returns : the return codes of pinPageWithPriority.
+ *
+ */
+
+static RC pinNode (BTree *treeInfo, PageNumber pageNum)
+{
+	BM_PinPriority priority = (pageNum == 0) ? BM_PRIORITY_HOT : BM_PRIORITY_NORMAL;
+	return pinPageWithPriority(treeInfo->bm,treeInfo->ph,pageNum,priority);
+}
+
+/*
+ * Function: unpinNode
+ * ---------------------------
+ * This function unpins the node page held by the tree's page handle and marks the handle as holding no page.
+ *
+ * treeInfo: Management structure for BTree Representation.
+ *
+ * returns : the return codes of unpinPage.
+ *
+ */
+
+static RC unpinNode (BTree *treeInfo)
+{
+	RC unpinFlag = unpinPage(treeInfo->bm,treeInfo->ph);
+	treeInfo->ph->pageNum = NO_PAGE;
+	return unpinFlag;
+}
 
 
 /*
@@ -124,6 +161,7 @@ RC createBtree (char *idxId, DataType keyType, int n)
  *
  * returns : RC_OK if open Btree is successful.
  *					RC_FILE_NOT_FOUND if openPagefile fails.
+ *					pinPage errors if the header page cannot be pinned.
  *
  */
 
@@ -139,9 +177,25 @@ RC openBtree (BTreeHandle **tree, char *idxId)
 	(*tree)->idxId = idxId;
 	treeInfo->bm = MAKE_POOL();
 	treeInfo->ph = MAKE_PAGE_HANDLE();
+	treeInfo->ph->pageNum = NO_PAGE;
 
-	initBufferPool(treeInfo->bm,idxId,6,RS_FIFO,NULL);
-	pinPage(treeInfo->bm,treeInfo->ph,1);
+	//use the global buffer pool when the application set one up, a private one otherwise
+	if(initSharedBufferPool(treeInfo->bm,idxId) != RC_OK)
+	{
+		initBufferPool(treeInfo->bm,idxId,6,RS_FIFO,NULL);
+	}
+	RC pinFlag = pinPageWithPriority(treeInfo->bm,treeInfo->ph,1,BM_PRIORITY_HOT);
+	if(pinFlag != RC_OK)
+	{
+		shutdownBufferPool(treeInfo->bm);
+		free(treeInfo->bm);
+		free(treeInfo->ph);
+		free(treeInfo);
+		free(*tree);
+		*tree = NULL;
+		closePageFile(&fh);
+		return pinFlag;
+	}
 	treeInfo->maxNumOfKeysPerNode = *((int*)treeInfo->ph->data);
 	treeInfo->nodeCounter=0;
 
@@ -149,7 +203,7 @@ RC openBtree (BTreeHandle **tree, char *idxId)
 	temp->mgmtData = treeInfo;
 	*tree = temp;
 
-	unpinPage(treeInfo->bm,treeInfo->ph);
+	unpinNode(treeInfo);
 	closePageFile(&fh);
 
 	return RC_OK;
@@ -163,11 +217,26 @@ RC openBtree (BTreeHandle **tree, char *idxId)
  * tree: Management structure for BTree Handle.
  *
  * returns : RC_OK if freeing treehandle is successful.
+ *					shutdownBufferPool errors if the pool cannot be shut down, the tree stays open then.
  *
  */
 
 RC closeBtree (BTreeHandle *tree)
 {
+	BTree *treeInfo = (BTree*)(tree->mgmtData);
+	//a node an insert returned early from is still pinned, the pool cannot give its frames up then
+	if(treeInfo->ph->pageNum != NO_PAGE)
+	{
+		unpinNode(treeInfo);
+	}
+	RC shutdownFlag = shutdownBufferPool(treeInfo->bm);
+	if(shutdownFlag != RC_OK)
+	{
+		return shutdownFlag;
+	}
+	free(treeInfo->bm);
+	free(treeInfo->ph);
+	free(treeInfo);
 	free(tree);
 	printf("Closing Btree..");
 	return RC_OK;
@@ -344,6 +413,7 @@ RC findKey (BTreeHandle *tree, Value *key, RID *result)
  * returns : RC_OK if inserting keys is successful.
  * 					RC_IM_KEY_NOT_FOUND if key is not found
  *					RC_RM_NO_PRINT_FOR_DATATYPE if datatype does not match.
+ *					pinPage errors if a node cannot be pinned, the key is not inserted then.
  */
 
 RC insertKey (BTreeHandle *tree, Value *key, RID rid)
@@ -351,11 +421,17 @@ RC insertKey (BTreeHandle *tree, Value *key, RID rid)
 	BTree *treeInfo = (BTree*)(tree->mgmtData);
 	bTreeCreate[numOfKeys] = (BTree*)malloc(sizeof(BTree));
 	int flagFound=0;
+	RC pinFlag;
 
 	
 	while(numOfKeys==0)
 	{
-		pinPage(treeInfo->bm,treeInfo->ph,numOfKeys);
+		pinFlag = pinNode(treeInfo,numOfKeys);
+		if(pinFlag != RC_OK)
+		{
+			free(bTreeCreate[numOfKeys]);
+			return pinFlag;
+		}
 		markDirty(treeInfo->bm,treeInfo->ph);
 		treeInfo->ph->data = "NotFull";
 
@@ -383,7 +459,7 @@ RC insertKey (BTreeHandle *tree, Value *key, RID rid)
 		bTreeCreate[numOfKeys]->rid.slot = rid.slot;
 
 		numOfKeys++;
-		unpinPage(treeInfo->bm,treeInfo->ph);
+		unpinNode(treeInfo);
 
 		return RC_OK;
 	}
@@ -416,14 +492,24 @@ RC insertKey (BTreeHandle *tree, Value *key, RID rid)
 
 		while(!flagFound)	
 		{
-			pinPage(treeInfo->bm,treeInfo->ph,treeInfo->nodeCounter);
+			pinFlag = pinNode(treeInfo,treeInfo->nodeCounter);
+			if(pinFlag != RC_OK)
+			{
+				free(bTreeCreate[numOfKeys]);
+				return pinFlag;
+			}
 			markDirty(treeInfo->bm,treeInfo->ph);
 
 			if(!(strcmp(treeInfo->ph->data,"NodeFull")))
 			{
 				treeInfo->nodeCounter++;
-				unpinPage(treeInfo->bm,treeInfo->ph);
-				pinPage(treeInfo->bm,treeInfo->ph,treeInfo->nodeCounter);
+				unpinNode(treeInfo);
+				pinFlag = pinNode(treeInfo,treeInfo->nodeCounter);
+				if(pinFlag != RC_OK)
+				{
+					free(bTreeCreate[numOfKeys]);
+					return pinFlag;
+				}
 
 				if(key->dt == DT_INT)
 				{
@@ -450,7 +536,7 @@ RC insertKey (BTreeHandle *tree, Value *key, RID rid)
 				bTreeCreate[numOfKeys]->rid.slot = rid.slot;
 				treeInfo->ph->data="NotFull";
 				numOfKeys++;
-				unpinPage(treeInfo->bm,treeInfo->ph);
+				unpinNode(treeInfo);
 			}
 			
 			else
@@ -481,7 +567,7 @@ RC insertKey (BTreeHandle *tree, Value *key, RID rid)
 
 				treeInfo->ph->data="NodeFull";
 				numOfKeys++;
-				unpinPage(treeInfo->bm,treeInfo->ph);
+				unpinNode(treeInfo);
 
 			}
 			return RC_OK;
@@ -502,6 +588,7 @@ RC insertKey (BTreeHandle *tree, Value *key, RID rid)
  * returns : RC_OK if deleting the key is successful.
  * 					RC_IM_KEY_NOT_FOUND if key is not found
  *					RC_RM_NO_PRINT_FOR_DATATYPE if datatype does not match.
+ *					pinPage errors if the node cannot be pinned, the key is not deleted then.
  */
 RC deleteKey (BTreeHandle *tree, Value *key)
 {
@@ -540,10 +627,14 @@ RC deleteKey (BTreeHandle *tree, Value *key)
 
 		if(flagFound)	
 		{
-			pinPage(treeInfo->bm,treeInfo->ph,(i/2));	
+			RC pinFlag = pinNode(treeInfo,(i/2));
+			if(pinFlag != RC_OK)
+			{
+				return pinFlag;
+			}
 			treeInfo->ph->data = "NotFull";				
 			markDirty(treeInfo->bm,treeInfo->ph);
-			unpinPage(treeInfo->bm,treeInfo->ph);
+			unpinNode(treeInfo);
 
 			deletedKeyIndex=i;
 			nextKeyIndex = deletedKeyIndex+1;
@@ -4,6 +4,11 @@
 #include "storage_mgr.h"
 #include "stdlib.h"
 #include "string.h"
+#include "pthread.h"
+#include "time.h"
+#include "stddef.h"
+#include "errno.h"
+#include "sys/time.h"
 
 /*Structure for Page Frame inside BufferPool
 	This contains pointers to the next and previous frams inside the buffer to form nodes of doubly linked list.
@@ -12,30 +17,153 @@
 typedef struct PageFrame
 {
 	int frameNum;
+	int fileId;
 	int pageNum;
 	int dirtyFlag;
 	int fixCount;
 	int refBit;
+	int ioInProgress;
+	BM_PinPriority priority;
 	char *data;
-	struct pageFrame *next, *prev;
+	struct PageFrame *next, *prev;
 }PageFrame;
 
+/*Entry of the queue of pins waiting for an evictable frame, lives on the waiting thread's stack.*/
+
+typedef struct PinWaiter
+{
+	struct PinWaiter *next;
+}PinWaiter;
+
 /*Structure for Buffer Pool Manager
 	This contains datastructures to navigate through bufferpool using linkedlists.
 	Some variables to get the statistics are also declared in this structure.*/
 
 typedef struct BManager
 {
+	int numFrames;
 	int occupiedCount;
+	bool shared;
+	char **fileNames;
+	int *fileRefs;
+	int numFiles;
+	ReplacementStrategy strategy;
 	void *stratData;
 	PageFrame *head,*tail,*start;
+	PageFrame *lastPinned;
 	PageNumber *frameContent;
 	int *fixCount;
 	bool *dirtyBit;
 	int numRead;
 	int numWrite;
+	pthread_mutex_t poolLock;
+	pthread_cond_t writerCond;
+	pthread_t writerThread;
+	bool writerRunning;
+	int writerIntervalMs;
+	int writerMaxWrites;
+	int writerCleanTarget;
+	pthread_cond_t ioCond;
+	pthread_cond_t ioDoneCond;
+	pthread_t prefetchThread;
+	bool prefetchRunning;
+	PageFrame **prefetchQueue;
+	int prefetchHead;
+	int prefetchCount;
+	BM_PoolStats stats;
+	pthread_cond_t frameFreeCond;
+	PinWaiter *waitHead, *waitTail;
+	int pinTimeoutMs;
+	FILE *traceFile;
+	struct timeval traceLast;
 }BManager;
 
+//Most pages the prefetch worker reads with one readBlocks call.
+#define PREFETCH_BATCH 32
+//How long a pin waits for an evictable frame before failing, see setPinWaitTimeout.
+#define DEFAULT_PIN_TIMEOUT_MS 1000
+//Eviction rank victimRank returns when every frame is pinned or being read.
+#define NO_VICTIM_RANK 3
+
+//Process-wide pool shared by all tables and indexes, see initGlobalBufferPool.
+static BManager *globalPool = NULL;
+static ReplacementStrategy globalStrategy;
+static bool warmupEnabled = false;
+
+//Counters summed over all pools using a strategy, see getStrategyStats.
+//Pools of all threads add to them, every access is atomic so a pin never waits for another pool.
+static BM_PoolStats strategyStats[RS_LRU_K + 1];
+#define STRATEGY_COUNTER(strategy, counter) ((long *) ((char *) &strategyStats[strategy] + (counter)))
+
+static RC stopBackgroundWriterOf(BManager *mgmt);
+static RC stopPrefetchWorkerOf(BManager *mgmt);
+static PageFrame *findFrame(BManager *mgmt, const int fileId, const PageNumber pageNum);
+static RC writeDirtyRuns(BManager *mgmt, const int fileId, SM_FileHandle *fh);
+static int compareFramesByPage(const void *a, const void *b);
+static void warmUpPool(BM_BufferPool *const bm);
+static void dumpResidentPages(BM_BufferPool *const bm, BManager *mgmt);
+static void frameReleased(BManager *mgmt);
+static PageFrame *findEmptyFrame(BManager *mgmt);
+static void emptyFrame(BManager *mgmt, PageFrame *frame);
+static bool fileReadInFlight(BManager *mgmt, const int fileId);
+static RC pinPageAs(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum, BM_AccessStrategy *const ring, BM_PinPriority priority);
+static PageFrame *takeRingFrame(BManager *mgmt, BM_AccessStrategy *const ring);
+static void recordRingFrame(BM_AccessStrategy *const ring, const int fileId, const PageNumber pageNum);
+
+/*
+ * Function: countEvent
+ * ---------------------------
+ * Increments one counter of the pool statistics and of the totals of the pool's strategy.
+ * Must be called with the pool lock held, which covers the pool's counter, the total is added atomically.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ * counter: Offset of the counter inside BM_PoolStats, e.g. offsetof(BM_PoolStats, hits).
+ *
+ * return: void
+ *
+ */
+
+static void countEvent(BManager *mgmt, size_t counter)
+{
+	(*(long *) ((char *) &mgmt->stats + counter))++;
+	__atomic_add_fetch(STRATEGY_COUNTER(mgmt->strategy, counter), 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * Function: traceEvent
+ * ---------------------------
+ * Appends one record to the trace of the pool if startBufferTrace turned tracing on.
+ * Must be called with the pool lock held, which keeps the records of all threads in order.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ * fileId: File of the page.
+ * pageNum: The page.
+ * op: What happened to the page.
+ *
+ * return: void
+ *
+ */
+
+static void traceEvent(BManager *mgmt, const int fileId, const PageNumber pageNum, BM_TraceOp op)
+{
+	BM_TraceRecord record;
+	struct timeval now;
+	long long delta;
+
+	if(mgmt->traceFile == NULL)
+	{
+		return;
+	}
+	gettimeofday(&now, NULL);
+	delta = (now.tv_sec - mgmt->traceLast.tv_sec) * 1000000LL + (now.tv_usec - mgmt->traceLast.tv_usec);
+	mgmt->traceLast = now;
+	record.deltaMicros = (delta < 0) ? 0 : (delta > 0xffffffffLL) ? 0xffffffffU : (unsigned int) delta;
+	record.fileId = fileId;
+	record.pageNum = pageNum;
+	record.op = op;
+	fwrite(&record, sizeof(BM_TraceRecord), 1, mgmt->traceFile);
+}
+
 /*
  * Function: createFrame
  * ---------------------------
@@ -53,8 +181,11 @@ void createPageFrame(BManager *mgmt)
 	frame->dirtyFlag = 0;
 	frame->fixCount = 0;
 	frame->frameNum = 0;
+	frame->fileId = -1;
 	frame->pageNum = -1;
 	frame->refBit = 0;
+	frame->ioInProgress = 0;
+	frame->priority = BM_PRIORITY_NORMAL;
 	frame->data = calloc(PAGE_SIZE,sizeof(char*));
 	mgmt->head = mgmt->start;
 
@@ -74,6 +205,143 @@ void createPageFrame(BManager *mgmt)
 	mgmt->head->prev = mgmt->tail;
 }
 
+/*
+* Function: createBufferManager
+* ---------------------------
+* Allocates the bookkeeping of a pool with numPages empty frames and no registered files.
+*
+* numPages: Number of frames
+* stratData: Extra parameters for the replacement strategy
+*
+* return: the new buffer manager
+*
+*/
+static BManager *createBufferManager(const int numPages, void *stratData)
+{
+	BManager *bp_mgmt = (BManager*)malloc(sizeof(BManager));
+	int i = 0;
+	bp_mgmt->start = NULL;
+	while(i<numPages)
+	{
+		createPageFrame(bp_mgmt);
+		i++;
+	}
+	bp_mgmt->tail = bp_mgmt->head;
+	bp_mgmt->numFrames = numPages;
+	bp_mgmt->shared = false;
+	bp_mgmt->fileNames = NULL;
+	bp_mgmt->fileRefs = NULL;
+	bp_mgmt->numFiles = 0;
+	bp_mgmt->stratData = stratData;
+	bp_mgmt->occupiedCount = 0;
+	bp_mgmt->numRead = 0;
+	bp_mgmt->numWrite = 0;
+	bp_mgmt->frameContent = NULL;
+	bp_mgmt->dirtyBit = NULL;
+	bp_mgmt->fixCount = NULL;
+	memset(&bp_mgmt->stats, 0, sizeof(BM_PoolStats));
+	bp_mgmt->writerRunning = false;
+	bp_mgmt->prefetchRunning = false;
+	bp_mgmt->prefetchQueue = (PageFrame **) malloc(sizeof(PageFrame *) * numPages);
+	bp_mgmt->prefetchHead = 0;
+	bp_mgmt->prefetchCount = 0;
+	pthread_mutex_init(&bp_mgmt->poolLock, NULL);
+	pthread_cond_init(&bp_mgmt->writerCond, NULL);
+	pthread_cond_init(&bp_mgmt->ioCond, NULL);
+	pthread_cond_init(&bp_mgmt->ioDoneCond, NULL);
+	pthread_cond_init(&bp_mgmt->frameFreeCond, NULL);
+	bp_mgmt->lastPinned = NULL;
+	bp_mgmt->waitHead = NULL;
+	bp_mgmt->waitTail = NULL;
+	bp_mgmt->pinTimeoutMs = DEFAULT_PIN_TIMEOUT_MS;
+	bp_mgmt->traceFile = NULL;
+	return bp_mgmt;
+}
+
+/*
+* Function: destroyBufferManager
+* ---------------------------
+* Frees all frames and the bookkeeping of a pool. Background threads must be stopped already.
+*
+* bp_mgmt: Structure which stores information about the buffer manager
+*
+* return: void
+*
+*/
+static void destroyBufferManager(BManager *bp_mgmt)
+{
+	PageFrame *pgeframe = bp_mgmt->head;
+	PageFrame *nextFrame;
+	int i;
+
+	for(i = 0; i < bp_mgmt->numFrames; i++)
+	{
+		nextFrame = pgeframe->next;
+		free(pgeframe->data);
+		free(pgeframe);
+		pgeframe = nextFrame;
+	}
+	for(i = 0; i < bp_mgmt->numFiles; i++)
+	{
+		free(bp_mgmt->fileNames[i]);
+	}
+	free(bp_mgmt->fileNames);
+	free(bp_mgmt->fileRefs);
+	free(bp_mgmt->prefetchQueue);
+	free(bp_mgmt->frameContent);
+	free(bp_mgmt->dirtyBit);
+	free(bp_mgmt->fixCount);
+	if(bp_mgmt->traceFile != NULL)
+	{
+		fclose(bp_mgmt->traceFile);
+	}
+	pthread_cond_destroy(&bp_mgmt->frameFreeCond);
+	pthread_cond_destroy(&bp_mgmt->ioDoneCond);
+	pthread_cond_destroy(&bp_mgmt->ioCond);
+	pthread_cond_destroy(&bp_mgmt->writerCond);
+	pthread_mutex_destroy(&bp_mgmt->poolLock);
+	free(bp_mgmt);
+}
+
+/*
+* Function: registerFile
+* ---------------------------
+* Returns the file id of a page file inside a pool, adding the file to the pool's file table
+* if it is not known yet. Frames are keyed by (file id, page number). Must be called with the pool lock held.
+*
+* bp_mgmt: Structure which stores information about the buffer manager
+* pageFileName: Name of the page file
+*
+* return: the file id
+*
+*/
+static int registerFile(BManager *bp_mgmt, const char *const pageFileName)
+{
+	int i, freeSlot = -1;
+
+	for(i = 0; i < bp_mgmt->numFiles; i++)
+	{
+		if(bp_mgmt->fileNames[i] != NULL && strcmp(bp_mgmt->fileNames[i], pageFileName) == 0)
+		{
+			bp_mgmt->fileRefs[i]++;
+			return i;
+		}
+		if(bp_mgmt->fileNames[i] == NULL && freeSlot < 0)
+		{
+			freeSlot = i;
+		}
+	}
+	if(freeSlot < 0)
+	{
+		freeSlot = bp_mgmt->numFiles++;
+		bp_mgmt->fileNames = (char **) realloc(bp_mgmt->fileNames, sizeof(char *) * bp_mgmt->numFiles);
+		bp_mgmt->fileRefs = (int *) realloc(bp_mgmt->fileRefs, sizeof(int) * bp_mgmt->numFiles);
+	}
+	bp_mgmt->fileNames[freeSlot] = strdup(pageFileName);
+	bp_mgmt->fileRefs[freeSlot] = 1;
+	return freeSlot;
+}
+
 /*
 * Function: initBufferPool
 * ---------------------------
@@ -93,26 +361,153 @@ void createPageFrame(BManager *mgmt)
 RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName, const int numPages, ReplacementStrategy strategy,void *stratData)
 {
 
-	BManager *bp_mgmt = (BManager*)malloc(sizeof(BManager));
-	bp_mgmt->start = NULL;
+	BManager *bp_mgmt = createBufferManager(numPages, stratData);
 	SM_FileHandle fHandle;
-	int i = 0;
-	openPageFile((char*) pageFileName,&fHandle);
-	while(i<numPages)
+	if(openPageFile((char*) pageFileName,&fHandle) == RC_OK)
 	{
-		createPageFrame(bp_mgmt);
-		i++;
+		closePageFile(&fHandle);
 	}
-	bp_mgmt->tail = bp_mgmt->head;
-	bp_mgmt->stratData = stratData;
-	bp_mgmt->occupiedCount = 0;
-	bp_mgmt->numRead = 0;
-	bp_mgmt->numWrite = 0;
+	bp_mgmt->strategy = strategy;
+	bm->fileId = registerFile(bp_mgmt, pageFileName);
 	bm->numPages = numPages;
 	bm->pageFile = (char*) pageFileName;
 	bm->strategy = strategy;
 	bm->mgmtData = bp_mgmt;
+	warmUpPool(bm);
+	return RC_OK;
+}
+
+/*
+* Function: initGlobalBufferPool
+* ---------------------------
+* Creates the process-wide buffer pool. Its numPages frames are the single memory budget
+* shared by every pool opened with initSharedBufferPool, replacement runs across all their files.
+* openTable and openBtree use it whenever it exists.
+*
+* numPages: Number of frames in the global pool
+* strategy: Page replacement algorithm used across all files.
+* stratData: Used to pass any extra parameters for working of strategy
+*
+* return: RC_OK if the global pool was created
+*         RC_BUFFER_POOL_ALREADY_INIT if the global pool already exists
+*
+*/
+RC initGlobalBufferPool(const int numPages, ReplacementStrategy strategy, void *stratData)
+{
+	if(globalPool != NULL)
+	{
+		return RC_BUFFER_POOL_ALREADY_INIT;
+	}
+	globalPool = createBufferManager(numPages, stratData);
+	globalPool->shared = true;
+	globalPool->strategy = strategy;
+	globalStrategy = strategy;
+	return RC_OK;
+}
+
+/*
+* Function: initSharedBufferPool
+* ---------------------------
+* Opens a page file in the global buffer pool. The returned BM_BufferPool is used
+* with pinPage, unpinPage, ... like a private pool, but owns no frames of its own.
+*
+* bm: Structure which stores information about the buffer pool
+* pageFileName: Name of the page file whose pages are cached
+*
+* return: RC_OK if the file was attached to the global pool
+*         RC_BM_GLOBAL_POOL_NOT_INIT if initGlobalBufferPool was not called
+*         RC_FILE_NOT_FOUND if the page file does not exist
+*
+*/
+RC initSharedBufferPool(BM_BufferPool *const bm, const char *const pageFileName)
+{
+	SM_FileHandle fHandle;
+
+	if(globalPool == NULL)
+	{
+		return RC_BM_GLOBAL_POOL_NOT_INIT;
+	}
+	if(openPageFile((char*) pageFileName,&fHandle) != RC_OK)
+	{
+		return RC_FILE_NOT_FOUND;
+	}
 	closePageFile(&fHandle);
+
+	pthread_mutex_lock(&globalPool->poolLock);
+	bm->fileId = registerFile(globalPool, pageFileName);
+	bm->numPages = globalPool->numFrames;
+	pthread_mutex_unlock(&globalPool->poolLock);
+	bm->pageFile = (char*) pageFileName;
+	bm->strategy = globalStrategy;
+	bm->mgmtData = globalPool;
+	warmUpPool(bm);
+	return RC_OK;
+}
+
+/*
+* Function: shutdownGlobalBufferPool
+* ---------------------------
+* Writes all dirty pages of the global pool back to their files and frees it.
+*
+* return: RC_OK if the global pool was destroyed
+*         RC_BM_GLOBAL_POOL_NOT_INIT if there is no global pool
+*         RC_BM_FRAMES_PINNED if a page is pinned, the pool stays up then.
+*         openPageFile or writeBlocks errors of the first file which cannot be written, the other
+*         files are still written and the pool stays up with the failed pages dirty.
+*
+*/
+RC shutdownGlobalBufferPool(void)
+{
+	PageFrame *pgeframe;
+	SM_FileHandle fh;
+	RC writeFlag, firstFlag = RC_OK;
+	int i;
+
+	if(globalPool == NULL)
+	{
+		return RC_BM_GLOBAL_POOL_NOT_INIT;
+	}
+	//a pinned page would lose its data, like detaching a file in shutdownBufferPool
+	pthread_mutex_lock(&globalPool->poolLock);
+	pgeframe = globalPool->head;
+	do
+	{
+		if(pgeframe->fixCount > 0)
+		{
+			pthread_mutex_unlock(&globalPool->poolLock);
+			return RC_BM_FRAMES_PINNED;
+		}
+		pgeframe = pgeframe->next;
+	}while(pgeframe != globalPool->head);
+	pthread_mutex_unlock(&globalPool->poolLock);
+	stopBackgroundWriterOf(globalPool);
+	stopPrefetchWorkerOf(globalPool);
+
+	pthread_mutex_lock(&globalPool->poolLock);
+	for(i = 0; i < globalPool->numFiles; i++)
+	{
+		if(globalPool->fileNames[i] == NULL)
+		{
+			continue;
+		}
+		writeFlag = openPageFile(globalPool->fileNames[i], &fh);
+		if(writeFlag == RC_OK)
+		{
+			writeFlag = writeDirtyRuns(globalPool, i, &fh);
+			closePageFile(&fh);
+		}
+		if(firstFlag == RC_OK)
+		{
+			firstFlag = writeFlag;
+		}
+	}
+	pthread_mutex_unlock(&globalPool->poolLock);
+	if(firstFlag != RC_OK)
+	{
+		return firstFlag;
+	}
+	destroyBufferManager(globalPool);
+	globalPool = NULL;
 	return RC_OK;
 }
 
@@ -125,33 +520,163 @@ RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName, const
 *
 * return: RC_OK if the bufferpool destroy is successful
 *         RC_BUFFER_POOL_NOT_INIT if the bufferpool doesnt exists.
+*         RC_BM_FRAMES_PINNED if the last handle of a file in the global pool is shut down
+*         while pages of the file are pinned, the handle stays attached then.
+*         openPageFile or writeBlocks errors if the file's pages cannot be written back.
 *
 */
 
 RC shutdownBufferPool(BM_BufferPool *const bm)
 {
 	BManager *bp_mgmt = bm->mgmtData;
-	PageFrame *pgeframe = bp_mgmt->head;
-	forceFlushPool(bm);
+	PageFrame *pgeframe;
+	SM_FileHandle fh;
+	RC writeFlag;
+	int i;
 
-	pgeframe= pgeframe->next;
-	while(pgeframe!=bp_mgmt->head)
+	if(bp_mgmt->shared)
 	{
-		free(pgeframe->data);
-		pgeframe= pgeframe->next;
+		//Detach from the global pool: write back this file's pages and give its frames up
+		pthread_mutex_lock(&bp_mgmt->poolLock);
+		if(bp_mgmt->fileRefs[bm->fileId] == 1)
+		{
+			while(fileReadInFlight(bp_mgmt, bm->fileId))
+			{
+				pthread_cond_wait(&bp_mgmt->ioDoneCond, &bp_mgmt->poolLock);
+			}
+			//the frames are given up below, a page still in use would lose its data
+			pgeframe = bp_mgmt->head;
+			do
+			{
+				if(pgeframe->fileId == bm->fileId && pgeframe->fixCount > 0)
+				{
+					pthread_mutex_unlock(&bp_mgmt->poolLock);
+					return RC_BM_FRAMES_PINNED;
+				}
+				pgeframe = pgeframe->next;
+			}while(pgeframe != bp_mgmt->head);
+		}
+		writeFlag = openPageFile((char *)(bm->pageFile), &fh);
+		if(writeFlag == RC_OK)
+		{
+			writeFlag = writeDirtyRuns(bp_mgmt, bm->fileId, &fh);
+			closePageFile(&fh);
+		}
+		if(writeFlag != RC_OK)
+		{
+			pthread_mutex_unlock(&bp_mgmt->poolLock);
+			return writeFlag;
+		}
+		if(--bp_mgmt->fileRefs[bm->fileId] == 0)
+		{
+			dumpResidentPages(bm, bp_mgmt);
+			pgeframe = bp_mgmt->head;
+			for(i = 0; i < bp_mgmt->numFrames; i++)
+			{
+				if(pgeframe->fileId == bm->fileId)
+				{
+					emptyFrame(bp_mgmt, pgeframe);
+				}
+				pgeframe = pgeframe->next;
+			}
+			free(bp_mgmt->fileNames[bm->fileId]);
+			bp_mgmt->fileNames[bm->fileId] = NULL;
+		}
+		pthread_mutex_unlock(&bp_mgmt->poolLock);
+		return RC_OK;
 	}
 
-	free(pgeframe);
-	bp_mgmt->start = NULL;
-	bp_mgmt->head = NULL;
-	bp_mgmt->tail = NULL;
+	stopBackgroundWriterOf(bp_mgmt);
+	stopPrefetchWorkerOf(bp_mgmt);
+	forceFlushPool(bm);
+	pthread_mutex_lock(&bp_mgmt->poolLock);
+	dumpResidentPages(bm, bp_mgmt);
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
+	destroyBufferManager(bp_mgmt);
+	bm->mgmtData = NULL;
 	return RC_OK;
 }
 
+/*
+ * Function: compareFramesByPage
+ * ---------------------------
+ * qsort comparator ordering frames by the page they hold.
+ *
+ * a, b: Pointers to the two PageFrame pointers.
+ *
+ * return: <0, 0 or >0 like strcmp.
+ *
+ */
+
+static int compareFramesByPage(const void *a, const void *b)
+{
+	return (*(PageFrame **) a)->pageNum - (*(PageFrame **) b)->pageNum;
+}
+
+/*
+ * Function: writeDirtyRuns
+ * ---------------------------
+ * Writes all dirty, unpinned frames of one file in page order. Frames holding consecutive
+ * pages are written together with one writeBlocks call, so a flush turns into a few
+ * sequential writes instead of one seek per page in ring order.
+ * Must be called with the pool lock held.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ * fileId: File whose frames are written.
+ * fh: Open handle of that file.
+ *
+ * return: RC_OK if all pages were written.
+ *         writeBlocks errors if a write fails, the pages of the failed run stay dirty.
+ *
+ */
+
+static RC writeDirtyRuns(BManager *mgmt, const int fileId, SM_FileHandle *fh)
+{
+	PageFrame **dirtyFrames = (PageFrame **) malloc(sizeof(PageFrame *) * mgmt->numFrames);
+	SM_PageHandle *runPages = (SM_PageHandle *) malloc(sizeof(SM_PageHandle) * mgmt->numFrames);
+	PageFrame *frame = mgmt->head;
+	int i, j, k, numDirty = 0;
+	RC writeFlag = RC_OK;
+
+	do
+	{
+		if(frame->fileId == fileId && frame->fixCount == 0 && frame->dirtyFlag != 0 && !frame->ioInProgress)
+		{
+			dirtyFrames[numDirty++] = frame;
+		}
+		frame = frame->next;
+	}while(frame != mgmt->head);
+	qsort(dirtyFrames, numDirty, sizeof(PageFrame *), compareFramesByPage);
+
+	for(i = 0; i < numDirty && writeFlag == RC_OK; i = j)
+	{
+		//extend the run while the next dirty page follows directly
+		for(j = i + 1; j < numDirty && dirtyFrames[j]->pageNum == dirtyFrames[j - 1]->pageNum + 1; j++);
+		for(k = i; k < j; k++)
+		{
+			runPages[k - i] = dirtyFrames[k]->data;
+		}
+		writeFlag = writeBlocks(dirtyFrames[i]->pageNum, j - i, fh, runPages);
+		if(writeFlag == RC_OK)
+		{
+			for(k = i; k < j; k++)
+			{
+				dirtyFrames[k]->dirtyFlag = 0;
+				mgmt->numWrite++;
+				countEvent(mgmt, offsetof(BM_PoolStats, flushWrites));
+			}
+		}
+	}
+	free(runPages);
+	free(dirtyFrames);
+	return writeFlag;
+}
+
 /*
 * Function: forceFlushPool
 * ---------------------------
-* This function writes all the pages marked as dirty to the disc
+* This function writes all the pages marked as dirty to the disc, sorted by page number
+* and coalesced into runs of consecutive pages, see writeDirtyRuns.
 *
 * bm: Structure which stores information about the buffer pool
 *
@@ -166,33 +691,20 @@ RC shutdownBufferPool(BM_BufferPool *const bm)
 RC forceFlushPool(BM_BufferPool *const bm)
 {
 	BManager *bp_mgmt = bm->mgmtData;
-	PageFrame *pgeframe = bp_mgmt->head;
 	SM_FileHandle fh;
+	RC writeFlag;
+	pthread_mutex_lock(&bp_mgmt->poolLock);
 	RC openpageFlag = openPageFile((char *)(bm->pageFile),&fh);
 
 	if (openpageFlag != RC_OK)
 	{
+		pthread_mutex_unlock(&bp_mgmt->poolLock);
 		return openpageFlag;
 	}
-	do
-	{
-		if(pgeframe->fixCount == 0 && pgeframe->dirtyFlag != 0)
-		{
-			RC writeFlag = writeBlock(pgeframe->pageNum, &fh, pgeframe->data);
-			if(writeFlag != RC_OK)
-			{
-				closePageFile(&fh);
-				return writeFlag;
-			}
-			else{
-				pgeframe->dirtyFlag = 0;
-				bp_mgmt->numWrite++;
-			}
-		}
-		pgeframe = pgeframe->next;
-	}while(pgeframe != bp_mgmt->head);
+	writeFlag = writeDirtyRuns(bp_mgmt, bm->fileId, &fh);
 	closePageFile(&fh);
-	return RC_OK;
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
+	return writeFlag;
 }
 
 /* Function: markDirty
@@ -209,22 +721,25 @@ RC forceFlushPool(BM_BufferPool *const bm)
 RC markDirty (BM_BufferPool *const bm, BM_PageHandle *const page)
 {
 	BManager *bp_mgmt = bm->mgmtData;
+	pthread_mutex_lock(&bp_mgmt->poolLock);
 	PageFrame *pgeframe = bp_mgmt->head;
 
 	do
 	{
 		//if the pageNum of page handle is same as the page in buffer frame
-		if(page->pageNum != pgeframe->pageNum)
+		if(page->pageNum != pgeframe->pageNum || pgeframe->fileId != bm->fileId)
 		{
 			pgeframe=pgeframe->next;
 		}
 		else{
 			pgeframe->dirtyFlag = 1;
-			return RC_OK;
+			traceEvent(bp_mgmt, bm->fileId, page->pageNum, BM_TRACE_DIRTY);
+			break;
 		}
 
 	}while(pgeframe!=bp_mgmt->head);
 
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
 	return RC_OK;
 }
 
@@ -242,26 +757,37 @@ RC markDirty (BM_BufferPool *const bm, BM_PageHandle *const page)
 RC unpinPage (BM_BufferPool *const bm, BM_PageHandle *const page)
 {
 	BManager *mgmt = bm->mgmtData;
+	pthread_mutex_lock(&mgmt->poolLock);
 	PageFrame *pgeFrame = mgmt->head;
-	if(page->pageNum == mgmt->head->pageNum)
+	if(page->pageNum == mgmt->head->pageNum && mgmt->head->fileId == bm->fileId)
 	{
-		mgmt->head->fixCount--;
+		if(--mgmt->head->fixCount == 0)
+		{
+			frameReleased(mgmt);
+		}
+		traceEvent(mgmt, bm->fileId, page->pageNum, BM_TRACE_UNPIN);
+		pthread_mutex_unlock(&mgmt->poolLock);
 		return RC_OK;
 	}
 	pgeFrame = pgeFrame->next;
 	while(pgeFrame!= mgmt->head)
 	{
-		if(page->pageNum != pgeFrame->pageNum)
+		if(page->pageNum != pgeFrame->pageNum || pgeFrame->fileId != bm->fileId)
 		{
 			pgeFrame = pgeFrame->next;
 		}
 		else{
-			pgeFrame->fixCount--;
-			return RC_OK;
+			if(--pgeFrame->fixCount == 0)
+			{
+				frameReleased(mgmt);
+			}
+			traceEvent(mgmt, bm->fileId, page->pageNum, BM_TRACE_UNPIN);
+			break;
 		}
 
 	}
 
+	pthread_mutex_unlock(&mgmt->poolLock);
 	return RC_OK;
 }
 
@@ -282,22 +808,26 @@ RC forcePage (BM_BufferPool *const bm, BM_PageHandle *const page)
 	BManager *bp_mgmt = bm->mgmtData;
 	PageFrame *Frame = bp_mgmt->head;
 	SM_FileHandle fh;
+	pthread_mutex_lock(&bp_mgmt->poolLock);
 	RC openpageFlag = openPageFile ((char *)(bm->pageFile), &fh);
 	//Open PageFile for write operation
 	if (openpageFlag != RC_OK)
 	{
+		pthread_mutex_unlock(&bp_mgmt->poolLock);
 		return RC_FILE_NOT_FOUND;
 	}
 	do
 	{
-		if(Frame->dirtyFlag == 1 && Frame->pageNum == page->pageNum )
+		if(Frame->dirtyFlag == 1 && Frame->pageNum == page->pageNum && Frame->fileId == bm->fileId)
 		{
 			if(writeBlock(Frame->pageNum, &fh, Frame->data) != RC_OK)
 			{
 				closePageFile(&fh);
+				pthread_mutex_unlock(&bp_mgmt->poolLock);
 				return RC_WRITE_FAILED;
 			}
 			bp_mgmt->numWrite++;
+			countEvent(bp_mgmt, offsetof(BM_PoolStats, forcedWrites));
 			Frame->dirtyFlag = 0;
 			break;
 		}
@@ -305,37 +835,107 @@ RC forcePage (BM_BufferPool *const bm, BM_PageHandle *const page)
 	}while(Frame!=bp_mgmt->head);
 
 	closePageFile(&fh);
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
 	return RC_OK;
 }
 /*
- * Function: pagePresent
+ * Function: pageReadInFlight
  * ---------------------------
- * This function returns RC_OK if the page is already present in the buffer.
+ * This function checks whether the prefetch worker or a pinPages call is currently reading the page into a frame.
  *
  * mgmt: Structure which stores information about the buffer Manager.
- * page: Structure which stored information about buffer page handle.
- * pageNum: This is a field in buffer page handle which stored the page number.
- *
- * return: RC_OK if the page pinning to the buffer pool is successful.
- *				 RC_IM_KEY_NOT_FOUND if page is not found in buffer.
+ * fileId: File the page belongs to.
+ * pageNum: Page number to look for.
  *
+ * return: true if a read of the page is in flight, false otherwise.
  *
  */
 
-RC pagePresent(BM_PageHandle *const page, BManager *mgmt, const PageNumber pageNum, char *algo){
-	// if page is already present in the buffer pool
+static bool pageReadInFlight(BManager *mgmt, const int fileId, const PageNumber pageNum)
+{
+	PageFrame *pgeframe = mgmt->head;
+	do
+	{
+		if(pgeframe->pageNum == pageNum && pgeframe->fileId == fileId && pgeframe->ioInProgress)
+		{
+			return true;
+		}
+		pgeframe = pgeframe->next;
+	}while(pgeframe != mgmt->head);
+	return false;
+}
+
+/*
+ * Function: fileReadInFlight
+ * ---------------------------
+ * This function checks whether the prefetch worker is reading any page of a file.
+ * Must be called with the pool lock held.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ * fileId: The file.
+ *
+ * return: true if a read of one of the file's pages is in flight, false otherwise.
+ *
+ */
+
+static bool fileReadInFlight(BManager *mgmt, const int fileId)
+{
 	PageFrame *pgeframe = mgmt->head;
+	do
+	{
+		if(pgeframe->fileId == fileId && pgeframe->ioInProgress)
+		{
+			return true;
+		}
+		pgeframe = pgeframe->next;
+	}while(pgeframe != mgmt->head);
+	return false;
+}
+
+/*
+ * Function: pagePresent
+ * ---------------------------
+ * This function returns RC_OK if the page is already present in the buffer.
+ *
+ * mgmt: Structure which stores information about the buffer Manager.
+ * page: Structure which stored information about buffer page handle.
+ * fileId: File the page belongs to.
+ * pageNum: This is a field in buffer page handle which stored the page number.
+ *
+ * If the page is still being read by the prefetch worker, the caller waits for
+ * that read instead of issuing a second one. Must be called with the pool lock held.
+ *
+ * return: RC_OK if the page pinning to the buffer pool is successful.
+ *				 RC_IM_KEY_NOT_FOUND if page is not found in buffer.
+ *
+ *
+ */
+
+RC pagePresent(BM_PageHandle *const page, BManager *mgmt, const int fileId, const PageNumber pageNum, char *algo){
+	// if page is already present in the buffer pool
+	PageFrame *pgeframe;
 	int flag = 0;
+	//wait for a prefetch of this page instead of reading it a second time
+	if(pageReadInFlight(mgmt, fileId, pageNum))
+	{
+		countEvent(mgmt, offsetof(BM_PoolStats, waits));
+		do
+		{
+			pthread_cond_wait(&mgmt->ioDoneCond, &mgmt->poolLock);
+		}while(pageReadInFlight(mgmt, fileId, pageNum));
+	}
+	pgeframe = mgmt->head;
 	do
 	{
 		//put the data onto the page and increment the fix count
-		if(pgeframe->pageNum == pageNum)
+		if(pgeframe->pageNum == pageNum && pgeframe->fileId == fileId)
 		{
 			page->pageNum = pageNum;
 			page->data = pgeframe->data;
 
 			pgeframe->pageNum = pageNum;
 			pgeframe->fixCount++;
+			mgmt->lastPinned = pgeframe;
 			if (algo == "LRU"){
 				//point the head and tail for replacement
 				mgmt->tail = mgmt->head->next;
@@ -351,6 +951,65 @@ RC pagePresent(BM_PageHandle *const page, BManager *mgmt, const PageNumber pageN
 	}
 }
 
+/*
+ * Function: findEmptyFrame
+ * ---------------------------
+ * This function looks for a frame holding no page, starting at mgmt->head. While the pool fills up
+ * that is head itself, later frames emptied by a shutdown or a failed read may sit anywhere in the ring.
+ * Must be called with the pool lock held.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ *
+ * return: the empty frame, or NULL if every frame holds a page.
+ *
+ */
+
+static PageFrame *findEmptyFrame(BManager *mgmt)
+{
+	PageFrame *frame = mgmt->head;
+
+	if(mgmt->occupiedCount >= mgmt->numFrames)
+	{
+		return NULL;
+	}
+	do
+	{
+		if(frame->pageNum == NO_PAGE && frame->fixCount == 0 && !frame->ioInProgress)
+		{
+			return frame;
+		}
+		frame = frame->next;
+	}while(frame != mgmt->head);
+	return NULL;
+}
+
+/*
+ * Function: emptyFrame
+ * ---------------------------
+ * This function drops the page a frame holds without writing it, the frame becomes empty again
+ * and counts as free in mgmt->occupiedCount. Must be called with the pool lock held.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ * frame: The frame to empty.
+ *
+ * return: void
+ *
+ */
+
+static void emptyFrame(BManager *mgmt, PageFrame *frame)
+{
+	if(frame->pageNum != NO_PAGE)
+	{
+		mgmt->occupiedCount--;
+	}
+	frame->fileId = -1;
+	frame->pageNum = NO_PAGE;
+	frame->dirtyFlag = 0;
+	frame->fixCount = 0;
+	frame->priority = BM_PRIORITY_NORMAL;
+	frameReleased(mgmt);
+}
+
 /*
  * Function: isEmptyBP
  * ---------------------------
@@ -359,28 +1018,246 @@ RC pagePresent(BM_PageHandle *const page, BManager *mgmt, const PageNumber pageN
  * bm: Structure which stores information about the buffer pool.
  * pageNum: This is a field in buffer page handle which stored the page number.
  *
- * return: RC_OK if the page pinning to the buffer pool is successful.
- *				 RC_IM_NO_MORE_ENTRIES if buffer is full.
+ * return: the frame the page was assigned to and pinned in.
+ *				 NULL if buffer is full.
  *
  *
  */
 
-void isEmptyBP(BM_BufferPool *const bm, const PageNumber pageNum )
+PageFrame *isEmptyBP(BM_BufferPool *const bm, const PageNumber pageNum )
 {
 	BManager *mgmt = bm->mgmtData;
-	PageFrame *pgeframe = mgmt->head;
+	PageFrame *pgeframe = findEmptyFrame(mgmt);
 
-	if(mgmt->occupiedCount < bm->numPages)
+	if(pgeframe != NULL)
 	{
-		pgeframe = mgmt->head;
+		pgeframe->fileId = bm->fileId;
 		pgeframe->pageNum = pageNum;
-		if(pgeframe->next != mgmt->head)
+		if(pgeframe == mgmt->head && pgeframe->next != mgmt->head)
 		{
 			mgmt->head = pgeframe->next;
 		}
 		pgeframe->fixCount++;
 		mgmt->occupiedCount++;
 	}
+	return pgeframe;
+}
+
+/*
+ * Function: writeFrameToFile
+ * ---------------------------
+ * This function writes the page held by a frame to the page file it belongs to.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ * frame: The frame to write.
+ *
+ * return: RC_OK if the page was written.
+ *				 openPageFile or writeBlock errors if the operations fail.
+ *
+ */
+
+static RC writeFrameToFile(BManager *mgmt, PageFrame *frame)
+{
+	SM_FileHandle frameFile;
+	RC writeFlag;
+
+	writeFlag = openPageFile(mgmt->fileNames[frame->fileId], &frameFile);
+	if(writeFlag != RC_OK)
+	{
+		return writeFlag;
+	}
+	writeFlag = writeBlock(frame->pageNum, &frameFile, frame->data);
+	closePageFile(&frameFile);
+	return writeFlag;
+}
+
+/*
+ * Function: writeVictim
+ * ---------------------------
+ * This function writes a dirty victim frame back before it is reused. In the global pool the
+ * victim may belong to another file than the page being pinned, that file is opened for the write.
+ *
+ * bm: Structure which stores information about the buffer pool the pin was issued on.
+ * mgmt: Structure which stores information about the buffer manager.
+ * frame: The victim frame.
+ * fh: File handle of bm's page file.
+ *
+ * return: RC_OK if the page was written.
+ *				 openPageFile or writeBlock errors if the operations fail.
+ *
+ */
+
+static RC writeVictim(BM_BufferPool *const bm, BManager *mgmt, PageFrame *frame, SM_FileHandle *fh)
+{
+	if(frame->fileId == bm->fileId)
+	{
+		ensureCapacity(frame->pageNum, fh);
+		return writeBlock(frame->pageNum, fh, frame->data);
+	}
+	return writeFrameToFile(mgmt, frame);
+}
+
+/*
+ * Function: hasEvictableFrame
+ * ---------------------------
+ * This function checks whether a miss can get a frame right now: an empty one, or one which is
+ * neither pinned nor being read by the prefetch worker. Must be called with the pool lock held.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ *
+ * return: true if a frame is available.
+ *
+ */
+
+static bool hasEvictableFrame(BManager *mgmt)
+{
+	PageFrame *frame = mgmt->head;
+
+	//an empty frame counts only if it is free as well, a claimed one may not hold its page yet
+	do
+	{
+		if(frame->fixCount == 0 && !frame->ioInProgress)
+		{
+			return true;
+		}
+		frame = frame->next;
+	}while(frame != mgmt->head);
+	return false;
+}
+
+/*
+ * Function: frameReleased
+ * ---------------------------
+ * This function wakes up the pins waiting for a frame after a frame may have become evictable.
+ * Must be called with the pool lock held.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ *
+ * return: void
+ *
+ */
+
+static void frameReleased(BManager *mgmt)
+{
+	if(mgmt->waitHead != NULL)
+	{
+		pthread_cond_broadcast(&mgmt->frameFreeCond);
+	}
+}
+
+/*
+ * Function: waitForEvictableFrame
+ * ---------------------------
+ * This function blocks a missing pin until a frame can be evicted, instead of replacing a pinned page.
+ * Waiting pins are served in arrival order: only the oldest waiter may take a freed frame, and a
+ * new miss queues behind the waiters even if a frame is free. Gives up after the pool's pin wait timeout.
+ * Must be called with the pool lock held; the lock stays held from the check to the eviction.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ *
+ * return: RC_OK if a frame can be evicted now.
+ *         RC_BM_PIN_TIMEOUT if no frame became evictable in time.
+ *
+ */
+
+static RC waitForEvictableFrame(BManager *mgmt)
+{
+	PinWaiter self, **link;
+	struct timespec deadline;
+	struct timeval started, ended;
+	bool timedOut = false;
+
+	if(mgmt->waitHead == NULL && hasEvictableFrame(mgmt))
+	{
+		return RC_OK;
+	}
+	countEvent(mgmt, offsetof(BM_PoolStats, pinWaits));
+	if(mgmt->pinTimeoutMs == 0)
+	{
+		countEvent(mgmt, offsetof(BM_PoolStats, pinWaitTimeouts));
+		return RC_BM_PIN_TIMEOUT;
+	}
+
+	self.next = NULL;
+	if(mgmt->waitTail != NULL)
+	{
+		mgmt->waitTail->next = &self;
+	}
+	else
+	{
+		mgmt->waitHead = &self;
+	}
+	mgmt->waitTail = &self;
+
+	gettimeofday(&started, NULL);
+	deadline.tv_sec = started.tv_sec + mgmt->pinTimeoutMs / 1000;
+	deadline.tv_nsec = started.tv_usec * 1000L + (long) (mgmt->pinTimeoutMs % 1000) * 1000000L;
+	if(deadline.tv_nsec >= 1000000000L)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
+	while(mgmt->waitHead != &self || !hasEvictableFrame(mgmt))
+	{
+		if(mgmt->pinTimeoutMs < 0)
+		{
+			pthread_cond_wait(&mgmt->frameFreeCond, &mgmt->poolLock);
+		}
+		else if(pthread_cond_timedwait(&mgmt->frameFreeCond, &mgmt->poolLock, &deadline) == ETIMEDOUT)
+		{
+			timedOut = mgmt->waitHead != &self || !hasEvictableFrame(mgmt);
+			break;
+		}
+	}
+
+	//leave the queue, a timed out waiter may sit anywhere in it
+	for(link = &mgmt->waitHead; *link != &self; link = &(*link)->next);
+	*link = self.next;
+	if(mgmt->waitTail == &self)
+	{
+		mgmt->waitTail = NULL;
+		for(link = &mgmt->waitHead; *link != NULL; link = &(*link)->next)
+		{
+			mgmt->waitTail = *link;
+		}
+	}
+	//the next waiter may be at the head now
+	frameReleased(mgmt);
+
+	gettimeofday(&ended, NULL);
+	mgmt->stats.pinWaitMicros += (ended.tv_sec - started.tv_sec) * 1000000L + (ended.tv_usec - started.tv_usec);
+	__atomic_add_fetch(STRATEGY_COUNTER(mgmt->strategy, offsetof(BM_PoolStats, pinWaitMicros)),
+			(ended.tv_sec - started.tv_sec) * 1000000L + (ended.tv_usec - started.tv_usec), __ATOMIC_RELAXED);
+	if(timedOut)
+	{
+		countEvent(mgmt, offsetof(BM_PoolStats, pinWaitTimeouts));
+		return RC_BM_PIN_TIMEOUT;
+	}
+	return RC_OK;
+}
+
+/*
+ * Function: setPinWaitTimeout
+ * ---------------------------
+ * Sets how long a pin which finds every frame pinned waits for an unpin before it fails
+ * with RC_BM_PIN_TIMEOUT. The default is DEFAULT_PIN_TIMEOUT_MS. For a pool attached with
+ * initSharedBufferPool this sets the timeout of the global pool.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * timeoutMs: Timeout in milliseconds, 0 to fail at once, negative to wait without limit.
+ *
+ * return: RC_OK
+ *
+ */
+
+RC setPinWaitTimeout(BM_BufferPool *const bm, int timeoutMs)
+{
+	BManager *mgmt = bm->mgmtData;
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	mgmt->pinTimeoutMs = timeoutMs;
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return RC_OK;
 }
 
 /*
@@ -394,82 +1271,272 @@ void isEmptyBP(BM_BufferPool *const bm, const PageNumber pageNum )
  *
  * return: RC_OK if the page pinning to the buffer pool is successful
  					RC_BUFFER_POOL_ALREADY_INIT if bufferpool is not initialized.
+ *				 RC_BM_PIN_TIMEOUT if every frame stayed pinned for the pin wait timeout.
+ *				 RC_FILE_NOT_FOUND if the page file cannot be opened.
+ *				 readBlock or writeBlock errors if the page cannot be read, the page is not pinned then.
  *
  *
  */
 
 RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page,const PageNumber pageNum)
 {
-	SM_FileHandle fh;
-	BManager *mgmt = bm->mgmtData;
-	RC pageExists;
-	openPageFile((char*) bm->pageFile,&fh);
+	return pinPageAs(bm, page, pageNum, NULL, BM_PRIORITY_NORMAL);
+}
 
-	switch(bm->strategy)
-	{
-	case RS_FIFO:
-			pageExists = pagePresent(page, mgmt,pageNum,"FIFO");
-			if(pageExists == RC_OK){
-				return RC_OK;
-			}
-			else{
-			pinWithFIFO(bm, page, pageNum,mgmt,fh);
-			}
-			break;
+/*
+ * Function: pinPageWithStrategy
+ * ---------------------------
+ * Same as pinPage, but a miss may be served from the private ring of an access strategy
+ * (see initAccessStrategy) instead of the pool's replacement policy. Once the ring holds
+ * ringSize frames, the frame at the ring's next slot is reused if it is unpinned,
+ * so a scan or bulk load recycles a few frames instead of flushing the whole pool.
+ * If that frame is in use, the page goes through FIFO/LRU and replaces the slot.
+ * Hits are served from the pool as usual.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * page: Structure which stored information about buffer page handle.
+ * pageNum: This is a field in buffer page handle which stored the page number.
+ * ring: Access strategy of the caller, or NULL for the normal replacement policy.
+ *
+ * return: RC_OK if the page pinning to the buffer pool is successful
+ *				 RC_FILE_NOT_FOUND if the page file cannot be opened.
+ *				 readBlock or writeBlock errors if a ring frame cannot be reused, the page is not pinned then.
+ *
+ */
 
-	case RS_LRU:
-				pageExists = pagePresent(page, mgmt,pageNum,"LRU");
-				if(pageExists == RC_OK){
-					return RC_OK;
-				}
-				else{
-				pinWithLRU(bm,page,pageNum,mgmt,fh);
-				}
-				break;
-	}
-	return RC_OK;
+RC pinPageWithStrategy (BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum, BM_AccessStrategy *const ring)
+{
+	return pinPageAs(bm, page, pageNum, ring, (ring != NULL) ? BM_PRIORITY_SCAN : BM_PRIORITY_NORMAL);
 }
 
 /*
- * Function: pinWithFIFO
+ * Function: pinPageWithPriority
  * ---------------------------
- * This function implements First In First Out Algorithm for page replacement
+ * Same as pinPage with a hint how long the page should stay in the pool. FIFO and LRU evict
+ * unpinned BM_PRIORITY_SCAN frames first, then BM_PRIORITY_NORMAL ones, and BM_PRIORITY_HOT frames
+ * only when every other frame is pinned. A frame keeps the highest priority it was pinned with
+ * until its page is evicted, so a normal pin of a hot page does not demote it.
  *
  * bm: Structure which stores information about the buffer pool.
  * page: Structure which stored information about buffer page handle.
  * pageNum: This is a field in buffer page handle which stored the page number.
+ * priority: Priority class of the page.
+ *
+ * return: the return codes of pinPage.
+ *
+ */
+
+RC pinPageWithPriority (BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum, BM_PinPriority priority)
+{
+	return pinPageAs(bm, page, pageNum, NULL, priority);
+}
+
+/*
+ * Function: evictionRank
+ * ---------------------------
+ * This function orders priority classes by how willingly their frames are evicted.
+ *
+ * priority: Priority class of a frame.
+ *
+ * return: 0 for BM_PRIORITY_SCAN, 1 for BM_PRIORITY_NORMAL, 2 for BM_PRIORITY_HOT.
+ *
+ */
+
+static int evictionRank(BM_PinPriority priority)
+{
+	switch(priority)
+	{
+	case BM_PRIORITY_SCAN:
+		return 0;
+	case BM_PRIORITY_HOT:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+/*
+ * Function: victimRank
+ * ---------------------------
+ * This function returns the eviction rank replacement has to take its victim from: the lowest
+ * rank among frames which are neither pinned nor being read. Must be called with the pool lock held.
+ *
  * mgmt: Structure which stores information about the buffer manager.
- * frame: Structure which stores information about the buffer frame.
- * fh: Structure which holds Filehandler.
  *
- * return: RC_OK if the page pinning to the buffer pool is successful.
- *				 RC_IM_KEY_NOT_FOUND if page is not found in buffer.
- *				 readBlock or writeBlock errors if the operations fail.
+ * return: the rank, NO_VICTIM_RANK if no frame can be evicted.
  *
  */
 
- RC pinWithFIFO(BM_BufferPool *const bm, BM_PageHandle *const page,const PageNumber pageNum, BManager *mgmt,SM_FileHandle fh )
- {
-    PageFrame *frame = mgmt->head;
-		//Filling the empty frames in the  bufferpool
-		if(mgmt->occupiedCount < bm->numPages)
+static int victimRank(BManager *mgmt)
+{
+	PageFrame *frame = mgmt->head;
+	int rank = NO_VICTIM_RANK;
+
+	do
+	{
+		if(frame->fixCount == 0 && !frame->ioInProgress && evictionRank(frame->priority) < rank)
 		{
-			isEmptyBP(bm,pageNum);
-			printf("Inserting remaining frames in empty spaces in buffer pool with FIFO");
+			rank = evictionRank(frame->priority);
 		}
-		else
-		{
+		frame = frame->next;
+	}while(frame != mgmt->head);
+	return rank;
+}
+
+/*
+ * Function: pinPageAs
+ * ---------------------------
+ * Shared implementation of pinPage, pinPageWithStrategy and pinPageWithPriority.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * page: Structure which stored information about buffer page handle.
+ * pageNum: This is a field in buffer page handle which stored the page number.
+ * ring: Access strategy of the caller, or NULL for the normal replacement policy.
+ * priority: Priority class the pinned frame is raised to.
+ *
+ * return: the return codes of pinPage.
+ *
+ */
+
+static RC pinPageAs (BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum, BM_AccessStrategy *const ring, BM_PinPriority priority)
+{
+	SM_FileHandle fh;
+	BManager *mgmt = bm->mgmtData;
+	PageFrame *frame;
+	RC pageExists;
+	RC pinFlag = RC_OK;
+	pthread_mutex_lock(&mgmt->poolLock);
+
+	pageExists = pagePresent(page, mgmt, bm->fileId, pageNum, bm->strategy == RS_LRU ? "LRU" : "FIFO");
+	if(pageExists == RC_OK)
+	{
+		countEvent(mgmt, offsetof(BM_PoolStats, hits));
+	}
+	else if(ring != NULL)
+	{
+		countEvent(mgmt, offsetof(BM_PoolStats, misses));
+		if(openPageFile((char*) bm->pageFile,&fh) != RC_OK)
+		{
+			pthread_mutex_unlock(&mgmt->poolLock);
+			return RC_FILE_NOT_FOUND;
+		}
+		frame = (ring->used == ring->ringSize) ? takeRingFrame(mgmt, ring) : NULL;
+		if(frame != NULL)
+		{
+			frame->fileId = bm->fileId;
+			frame->pageNum = pageNum;
+			frame->fixCount++;
+			frame->priority = BM_PRIORITY_SCAN;
+			ensureCapacity((pageNum+1),&fh);
+			pinFlag = readBlock(pageNum, &fh, frame->data);
+			closePageFile(&fh);
+			if(pinFlag == RC_OK)
+			{
+				mgmt->numRead++;
+				mgmt->lastPinned = frame;
+				page->pageNum = pageNum;
+				page->data = frame->data;
+			}
+			else
+			{
+				//the old page is gone already, do not hand out a frame of garbage
+				emptyFrame(mgmt, frame);
+			}
+		}
+		else
+		{
+			pinFlag = (bm->strategy == RS_LRU) ? pinWithLRU(bm, page, pageNum, mgmt, fh) : pinWithFIFO(bm, page, pageNum, mgmt, fh);
+		}
+		if(pinFlag == RC_OK)
+		{
+			recordRingFrame(ring, bm->fileId, pageNum);
+		}
+	}
+	else
+	{
+		countEvent(mgmt, offsetof(BM_PoolStats, misses));
+		if(openPageFile((char*) bm->pageFile,&fh) != RC_OK)
+		{
+			pthread_mutex_unlock(&mgmt->poolLock);
+			return RC_FILE_NOT_FOUND;
+		}
+		switch(bm->strategy)
+		{
+		case RS_FIFO:
+			pinFlag = pinWithFIFO(bm, page, pageNum,mgmt,fh);
+			break;
+
+		case RS_LRU:
+			pinFlag = pinWithLRU(bm,page,pageNum,mgmt,fh);
+			break;
+		}
+	}
+
+	if(pinFlag == RC_OK)
+	{
+		if(evictionRank(priority) > evictionRank(mgmt->lastPinned->priority))
+		{
+			mgmt->lastPinned->priority = priority;
+		}
+		traceEvent(mgmt, bm->fileId, pageNum, BM_TRACE_PIN);
+	}
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return pinFlag;
+}
+
+/*
+ * Function: pinWithFIFO
+ * ---------------------------
+ * This function implements First In First Out Algorithm for page replacement
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * page: Structure which stored information about buffer page handle.
+ * pageNum: This is a field in buffer page handle which stored the page number.
+ * mgmt: Structure which stores information about the buffer manager.
+ * frame: Structure which stores information about the buffer frame.
+ * fh: Structure which holds Filehandler.
+ *
+ * return: RC_OK if the page pinning to the buffer pool is successful.
+ *				 RC_IM_KEY_NOT_FOUND if page is not found in buffer.
+ *				 RC_BM_PIN_TIMEOUT if no frame became evictable in time.
+ *				 readBlock or writeBlock errors if the operations fail.
+ *
+ */
+
+ RC pinWithFIFO(BM_BufferPool *const bm, BM_PageHandle *const page,const PageNumber pageNum, BManager *mgmt,SM_FileHandle fh )
+ {
+    PageFrame *frame;
+    int rank;
+		//Filling the empty frames in the  bufferpool
+		if((frame = isEmptyBP(bm,pageNum)) != NULL)
+		{
+			printf("Inserting remaining frames in empty spaces in buffer pool with FIFO");
+		}
+		else if(waitForEvictableFrame(mgmt) != RC_OK)
+		{
+			closePageFile(&fh);
+			return RC_BM_PIN_TIMEOUT;
+		}
+		//a frame emptied while the pin waited is taken before a page is evicted
+		else if((frame = isEmptyBP(bm,pageNum)) == NULL)
+		{
+			rank = victimRank(mgmt);
+			if(rank == NO_VICTIM_RANK)
+			{
+				//never read into a pinned frame or one being read
+				closePageFile(&fh);
+				return RC_BM_FRAMES_PINNED;
+			}
 			frame = mgmt->tail;
 			do
 			{
-				// check If the page is in use?
-				if(frame->fixCount == 0)
+				// check If the page is in use or still being prefetched, or if a less valuable page can go first?
+				if(frame->fixCount == 0 && !frame->ioInProgress && evictionRank(frame->priority) == rank)
 				{
 					//If dirty, write the page back to the disc from disc frame.
 					if(frame->dirtyFlag != 0)
 					{
-						ensureCapacity(frame->pageNum, &fh);
-						RC writeFlag = writeBlock(frame->pageNum,&fh, frame->data);
+						RC writeFlag = writeVictim(bm, mgmt, frame, &fh);
 						if(writeFlag!=RC_OK)
 						{
 							closePageFile(&fh);
@@ -478,9 +1545,15 @@ RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page,const PageNumber
 						else{
 							mgmt->numWrite++;
 						}
-
+						countEvent(mgmt, offsetof(BM_PoolStats, dirtyEvictions));
 					}
+					else
+					{
+						countEvent(mgmt, offsetof(BM_PoolStats, cleanEvictions));
+					}
+					frame->fileId = bm->fileId;
 					frame->pageNum = pageNum;
+					frame->dirtyFlag = 0;
 					frame->fixCount++;
 					mgmt->tail = frame->next;
 					mgmt->head = frame;
@@ -491,7 +1564,8 @@ RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page,const PageNumber
 				{
 					frame = frame->next;
 				}
-			}while(frame!= mgmt->head);
+				//go all the way round, the frame at head may be the only unpinned one
+			}while(frame!= mgmt->tail);
 		}
 
 		//Add pages in pagefile if not sufficient
@@ -499,6 +1573,7 @@ RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page,const PageNumber
 		RC readFlag = readBlock(pageNum, &fh,frame->data);
 		if(readFlag!=RC_OK)
 		{
+			emptyFrame(mgmt, frame);
 			closePageFile(&fh);
 			return readFlag;
 		}
@@ -506,126 +1581,1456 @@ RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page,const PageNumber
 			mgmt->numRead++;
 		}
 
+		//a newly read page starts in the lowest class, the pin raises it
+		frame->priority = BM_PRIORITY_SCAN;
+		mgmt->lastPinned = frame;
 		page->pageNum = pageNum;
 		page->data = frame->data;
 
 		closePageFile(&fh);
 
-		return RC_OK;
- }
+		return RC_OK;
+ }
+
+ /*
+  * Function: pinWithLRU
+  * ---------------------------
+  * This function implements Least Recently Used Algorithm for page replacement
+  *
+  * bm: Structure which stores information about the buffer pool.
+  * page: Structure which stores information about buffer page handle.
+  * pageNum: This is a field in buffer page handle which stored the page number.
+  * mgmt: Structure which stores information about the buffer manager.
+  * frame: Structure which stores information about the buffer frame.
+  * fh: Structure which holds Filehandler.
+  *
+  * return: RC_OK if the page pinning to the buffer pool is successful.
+  *				 RC_IM_KEY_NOT_FOUND if page is not found in buffer.
+  *				 RC_BM_PIN_TIMEOUT if no frame became evictable in time.
+  *				 readBlock or writeBlock errors if the operations fail.
+  *
+  *
+  */
+
+ RC pinWithLRU(BM_BufferPool *const bm, BM_PageHandle *const page,const PageNumber pageNum,BManager *mgmt, SM_FileHandle fh)
+ {
+	 PageFrame *frame;
+	 int rank;
+	 bool reuseNext;
+
+  if((frame = isEmptyBP(bm,pageNum)) != NULL)
+  {
+ 	 printf("Inserting remaining frames in empty spaces in buffer pool with LRU");
+  }
+  else if(waitForEvictableFrame(mgmt) != RC_OK)
+  {
+ 	 closePageFile(&fh);
+ 	 return RC_BM_PIN_TIMEOUT;
+  }
+  //a frame emptied while the pin waited is taken before a page is evicted
+  else if((frame = isEmptyBP(bm,pageNum)) == NULL)
+  {
+ 	 rank = victimRank(mgmt);
+ 	 if(rank == NO_VICTIM_RANK)
+ 	 {
+ 		 //never read into a pinned frame or one being read
+ 		 closePageFile(&fh);
+ 		 return RC_BM_FRAMES_PINNED;
+ 	 }
+ 	 frame = mgmt->tail;
+ 	 do
+ 	 {
+ 		 if(frame->fixCount == 0 && !frame->ioInProgress && evictionRank(frame->priority) == rank)
+ 		 {
+ 			 //when the hand sits on the most recently used frame, the frame behind it is the one replaced
+ 			 reuseNext = mgmt->tail == mgmt->head && frame->next->fixCount == 0 && !frame->next->ioInProgress
+ 					 && evictionRank(frame->next->priority) == rank;
+ 			 if(reuseNext)
+ 			 {
+ 				 frame = frame->next;
+ 			 }
+ 			 //If dirty then write back to disc using writeBlock function
+ 			 if(frame->dirtyFlag != 0)
+ 			 {
+ 				 RC writeFlag = writeVictim(bm, mgmt, frame, &fh);
+ 				 if(writeFlag!=RC_OK)
+ 				 {
+ 					 closePageFile(&fh);
+ 					 return writeFlag;
+ 				 }
+ 				 else{
+ 					 mgmt->numWrite++;
+ 				 }
+ 				 countEvent(mgmt, offsetof(BM_PoolStats, dirtyEvictions));
+ 			 }
+ 			 else
+ 			 {
+ 				 countEvent(mgmt, offsetof(BM_PoolStats, cleanEvictions));
+ 			 }
+
+ 			 //Replacing the page which is least recently used.
+ 			 frame->fileId = bm->fileId;
+ 			 frame->pageNum = pageNum;
+ 			 frame->dirtyFlag = 0;
+ 			 frame->fixCount++;
+ 			 if(reuseNext)
+ 			 {
+ 				 mgmt->head = frame;
+ 				 mgmt->tail = frame->prev;
+ 			 }
+ 			 else
+ 			 {
+ 				 mgmt->tail = frame->next;
+ 			 }
+ 			 break;
+ 		 }
+ 		 else
+ 		 {
+ 			 frame = frame->next;
+ 		 }
+ 	 }while(frame!= mgmt->tail);
+  }
+  //Add pages if not sufficient
+  ensureCapacity((pageNum+1),&fh);
+  RC readFlag = readBlock(pageNum, &fh,frame->data);
+  if(readFlag!=RC_OK)
+  {
+ 	 emptyFrame(mgmt, frame);
+ 	 closePageFile(&fh);
+ 	 return readFlag;
+  }
+  else{
+ 	 mgmt->numRead++;
+  }
+
+  frame->priority = BM_PRIORITY_SCAN;
+  mgmt->lastPinned = frame;
+  page->pageNum = pageNum;
+  page->data = frame->data;
+
+
+  closePageFile(&fh);
+
+  return RC_OK;
+ }
+
+
+/*
+ * Function: claimVictimFrame
+ * ---------------------------
+ * This function picks the frame a missing page is read into without reading it: an empty frame
+ * while the pool fills up, otherwise the first unpinned frame from the replacement hand, written
+ * back if dirty. The frame is assigned to the page and pinned. Must be called with the pool lock held.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * mgmt: Structure which stores information about the buffer manager.
+ * pageNum: Page which will be read into the frame.
+ * fh: File handle of bm's page file.
+ * victim: Receives the frame, NULL if none was claimed.
+ *
+ * return: RC_OK if a frame was claimed.
+ *         RC_BM_FRAMES_PINNED if every frame is pinned.
+ *         writeBlock errors if the dirty victim cannot be written back.
+ *
+ */
+
+static RC claimVictimFrame(BM_BufferPool *const bm, BManager *mgmt, const PageNumber pageNum, SM_FileHandle *fh, PageFrame **victim)
+{
+	PageFrame *frame = findEmptyFrame(mgmt);
+	int rank;
+	RC writeFlag;
+
+	*victim = NULL;
+
+	if(frame != NULL)
+	{
+		if(frame == mgmt->head && frame->next != mgmt->head)
+		{
+			mgmt->head = frame->next;
+		}
+		mgmt->occupiedCount++;
+	}
+	else
+	{
+		rank = victimRank(mgmt);
+		frame = mgmt->tail;
+		while(frame->fixCount != 0 || frame->ioInProgress || evictionRank(frame->priority) != rank)
+		{
+			frame = frame->next;
+			if(frame == mgmt->tail)
+			{
+				return RC_BM_FRAMES_PINNED;
+			}
+		}
+		if(frame->dirtyFlag != 0)
+		{
+			writeFlag = writeVictim(bm, mgmt, frame, fh);
+			if(writeFlag != RC_OK)
+			{
+				return writeFlag;
+			}
+			mgmt->numWrite++;
+			countEvent(mgmt, offsetof(BM_PoolStats, dirtyEvictions));
+		}
+		else
+		{
+			countEvent(mgmt, offsetof(BM_PoolStats, cleanEvictions));
+		}
+		mgmt->tail = frame->next;
+		mgmt->head = frame;
+	}
+	frame->fileId = bm->fileId;
+	frame->pageNum = pageNum;
+	frame->dirtyFlag = 0;
+	frame->fixCount = 1;
+	frame->priority = BM_PRIORITY_NORMAL;
+	*victim = frame;
+	return RC_OK;
+}
+
+/*
+ * Function: pinPages
+ * ---------------------------
+ * This function pins n pages with a single I/O pass. Pages already in the pool are pinned first,
+ * then a victim frame is picked for every missing page, and the missing pages are read
+ * sorted by page number with one readBlocks call per run of consecutive pages.
+ * A page listed twice is pinned twice, like two pinPage calls. Like pinPage, a missing page waits
+ * in the pool's queue of pins for an evictable frame, see waitForEvictableFrame.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * pages: Array of n page handles, pages[i] receives page pageNums[i].
+ * pageNums: Pages to pin.
+ * n: Number of pages.
+ *
+ * return: RC_OK if all pages are pinned.
+ *         RC_FILE_NOT_FOUND if the page file cannot be opened.
+ *         RC_BM_PIN_TIMEOUT if no frame for a missing page became evictable within the pin wait timeout,
+ *         no page is pinned then.
+ *         RC_BM_FRAMES_PINNED if there are not enough unpinned frames, no page is pinned then.
+ *         writeBlock errors if a dirty victim cannot be written back, no page is pinned then.
+ *         readBlocks errors if a read fails, no page is pinned then.
+ *
+ */
+
+RC pinPages(BM_BufferPool *const bm, BM_PageHandle *const pages, const PageNumber *pageNums, const int n)
+{
+	BManager *mgmt = bm->mgmtData;
+	PageFrame **frames = (PageFrame **) malloc(sizeof(PageFrame *) * n);
+	PageFrame **misses = (PageFrame **) malloc(sizeof(PageFrame *) * n);
+	SM_PageHandle *runPages = (SM_PageHandle *) malloc(sizeof(SM_PageHandle) * n);
+	SM_FileHandle fh;
+	int i, j, k, numMisses = 0;
+	PageNumber lastPage = -1;
+	RC rc = RC_OK;
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	if(openPageFile((char*) bm->pageFile, &fh) != RC_OK)
+	{
+		pthread_mutex_unlock(&mgmt->poolLock);
+		free(runPages);
+		free(misses);
+		free(frames);
+		return RC_FILE_NOT_FOUND;
+	}
+
+	//hits first, so the victims picked below can never be one of the requested pages
+	for(i = 0; i < n; i++)
+	{
+		while(pageReadInFlight(mgmt, bm->fileId, pageNums[i]))
+		{
+			pthread_cond_wait(&mgmt->ioDoneCond, &mgmt->poolLock);
+		}
+		frames[i] = findFrame(mgmt, bm->fileId, pageNums[i]);
+		if(frames[i] != NULL)
+		{
+			frames[i]->fixCount++;
+			if(frames[i]->priority == BM_PRIORITY_SCAN)
+			{
+				frames[i]->priority = BM_PRIORITY_NORMAL;
+			}
+			countEvent(mgmt, offsetof(BM_PoolStats, hits));
+		}
+	}
+	for(i = 0; i < n && rc == RC_OK; i++)
+	{
+		if(frames[i] != NULL)
+		{
+			continue;
+		}
+		//a page listed twice is read once, into the frame claimed for its first miss
+		for(k = 0; k < numMisses && misses[k]->pageNum != pageNums[i]; k++);
+		if(k < numMisses)
+		{
+			frames[i] = misses[k];
+			frames[i]->fixCount++;
+			continue;
+		}
+		//queue behind earlier pins for a frame, the lock may be given up while waiting
+		rc = waitForEvictableFrame(mgmt);
+		if(rc != RC_OK)
+		{
+			break;
+		}
+		while(pageReadInFlight(mgmt, bm->fileId, pageNums[i]))
+		{
+			pthread_cond_wait(&mgmt->ioDoneCond, &mgmt->poolLock);
+		}
+		//a page read by another pin meanwhile is a hit
+		frames[i] = findFrame(mgmt, bm->fileId, pageNums[i]);
+		if(frames[i] != NULL)
+		{
+			frames[i]->fixCount++;
+			continue;
+		}
+		rc = claimVictimFrame(bm, mgmt, pageNums[i], &fh, &frames[i]);
+		if(rc != RC_OK)
+		{
+			break;
+		}
+		//the frame holds the evicted page until the read below, other pins of the page wait for it
+		frames[i]->ioInProgress = 1;
+		misses[numMisses++] = frames[i];
+		countEvent(mgmt, offsetof(BM_PoolStats, misses));
+		if(pageNums[i] > lastPage)
+		{
+			lastPage = pageNums[i];
+		}
+	}
+
+	if(rc == RC_OK && numMisses > 0)
+	{
+		qsort(misses, numMisses, sizeof(PageFrame *), compareFramesByPage);
+		ensureCapacity(lastPage + 1, &fh);
+		for(i = 0; i < numMisses && rc == RC_OK; i = j)
+		{
+			for(j = i + 1; j < numMisses && misses[j]->pageNum == misses[j - 1]->pageNum + 1; j++);
+			for(k = i; k < j; k++)
+			{
+				runPages[k - i] = misses[k]->data;
+			}
+			rc = readBlocks(misses[i]->pageNum, j - i, &fh, runPages);
+			if(rc == RC_OK)
+			{
+				mgmt->numRead += j - i;
+			}
+		}
+	}
+	for(k = 0; k < numMisses; k++)
+	{
+		misses[k]->ioInProgress = 0;
+	}
+	if(numMisses > 0)
+	{
+		pthread_cond_broadcast(&mgmt->ioDoneCond);
+	}
+
+	if(rc != RC_OK)
+	{
+		//release what this call pinned, frames claimed for a miss become empty again
+		for(k = 0; k < n; k++)
+		{
+			if(frames[k] != NULL && frames[k]->fixCount > 0)
+			{
+				frames[k]->fixCount--;
+			}
+		}
+		for(k = 0; k < numMisses; k++)
+		{
+			emptyFrame(mgmt, misses[k]);
+		}
+	}
+	else
+	{
+		for(i = 0; i < n; i++)
+		{
+			pages[i].pageNum = pageNums[i];
+			pages[i].data = frames[i]->data;
+			traceEvent(mgmt, bm->fileId, pageNums[i], BM_TRACE_PIN);
+		}
+	}
+	closePageFile(&fh);
+	pthread_mutex_unlock(&mgmt->poolLock);
+	free(runPages);
+	free(misses);
+	free(frames);
+	return rc;
+}
+
+/*
+ * Function: initAccessStrategy
+ * ---------------------------
+ * Sets up a ring access strategy for pinPageWithStrategy. The ring remembers the last ringSize
+ * pages it read and recycles their frames, a caller reading pages once (a sequential scan,
+ * a bulk load) then keeps at most ringSize frames of the pool busy.
+ * One ring belongs to one caller and one buffer pool.
+ *
+ * ring: The access strategy to set up.
+ * ringSize: Number of frames in the ring.
+ *
+ * return: RC_OK if the ring was set up.
+ *         RC_BM_INVALID_POOL_SIZE if ringSize is not positive.
+ *
+ */
+
+RC initAccessStrategy(BM_AccessStrategy *const ring, const int ringSize)
+{
+	if(ringSize <= 0)
+	{
+		return RC_BM_INVALID_POOL_SIZE;
+	}
+	ring->ringSize = ringSize;
+	ring->used = 0;
+	ring->nextSlot = 0;
+	ring->fileIds = (int *) malloc(sizeof(int) * ringSize);
+	ring->pageNums = (PageNumber *) malloc(sizeof(PageNumber) * ringSize);
+	return RC_OK;
+}
+
+/*
+ * Function: freeAccessStrategy
+ * ---------------------------
+ * Releases a ring set up with initAccessStrategy. The frames stay in the pool and are
+ * replaced by the normal policy from then on.
+ *
+ * ring: The access strategy.
+ *
+ * return: RC_OK
+ *
+ */
+
+RC freeAccessStrategy(BM_AccessStrategy *const ring)
+{
+	free(ring->fileIds);
+	free(ring->pageNums);
+	ring->fileIds = NULL;
+	ring->pageNums = NULL;
+	ring->used = 0;
+	return RC_OK;
+}
+
+/*
+ * Function: takeRingFrame
+ * ---------------------------
+ * Returns the frame of the ring's next slot if it can be reused, writing it back if dirty.
+ * The ring stores page numbers instead of frames, so a page another caller evicted in the
+ * meantime, or a frame released by resizeBufferPool, is simply not found.
+ * Must be called with the pool lock held.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ * ring: The access strategy, it must be full.
+ *
+ * return: the frame, or NULL if the slot's page is gone or its frame is in use.
+ *
+ */
+
+static PageFrame *takeRingFrame(BManager *mgmt, BM_AccessStrategy *const ring)
+{
+	PageFrame *frame = findFrame(mgmt, ring->fileIds[ring->nextSlot], ring->pageNums[ring->nextSlot]);
+
+	if(frame == NULL || frame->fixCount != 0 || frame->ioInProgress || frame->priority == BM_PRIORITY_HOT)
+	{
+		return NULL;
+	}
+	if(frame->dirtyFlag != 0)
+	{
+		if(writeFrameToFile(mgmt, frame) != RC_OK)
+		{
+			return NULL;
+		}
+		mgmt->numWrite++;
+		frame->dirtyFlag = 0;
+		countEvent(mgmt, offsetof(BM_PoolStats, dirtyEvictions));
+	}
+	else
+	{
+		countEvent(mgmt, offsetof(BM_PoolStats, cleanEvictions));
+	}
+	countEvent(mgmt, offsetof(BM_PoolStats, ringReuses));
+	return frame;
+}
+
+/*
+ * Function: recordRingFrame
+ * ---------------------------
+ * Stores a page read through the ring in the next free slot, or in the slot which was
+ * just recycled once the ring is full.
+ *
+ * ring: The access strategy.
+ * fileId: File the page belongs to.
+ * pageNum: The page.
+ *
+ * return: void
+ *
+ */
+
+static void recordRingFrame(BM_AccessStrategy *const ring, const int fileId, const PageNumber pageNum)
+{
+	int slot;
+
+	if(ring->used < ring->ringSize)
+	{
+		slot = ring->used++;
+	}
+	else
+	{
+		slot = ring->nextSlot;
+		ring->nextSlot = (ring->nextSlot + 1) % ring->ringSize;
+	}
+	ring->fileIds[slot] = fileId;
+	ring->pageNums[slot] = pageNum;
+}
+
+/*
+ * Function: unlinkFrame
+ * ---------------------------
+ * This function takes a frame out of the ring and frees it, moving the head, tail and start
+ * pointers past it if needed. Must be called with the pool lock held.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ * frame: The frame to remove, it must be unpinned and clean.
+ *
+ * return: void
+ *
+ */
+
+static void unlinkFrame(BManager *mgmt, PageFrame *frame)
+{
+	PageFrame *nextFrame = frame->next;
+
+	if(mgmt->head == frame)
+	{
+		mgmt->head = nextFrame;
+	}
+	if(mgmt->tail == frame)
+	{
+		mgmt->tail = nextFrame;
+	}
+	if(mgmt->start == frame)
+	{
+		mgmt->start = nextFrame;
+	}
+	frame->prev->next = nextFrame;
+	nextFrame->prev = frame->prev;
+	free(frame->data);
+	free(frame);
+	mgmt->numFrames--;
+}
+
+/*
+ * Function: resizePrefetchQueue
+ * ---------------------------
+ * This function reallocates the prefetch queue for a new number of frames, keeping queued reads in order.
+ * Must be called before mgmt->numFrames changes, the old queue is indexed modulo the old size.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ * newNumPages: The number of frames after the resize.
+ *
+ * return: void
+ *
+ */
+
+static void resizePrefetchQueue(BManager *mgmt, const int newNumPages)
+{
+	PageFrame **newQueue = (PageFrame **) malloc(sizeof(PageFrame *) * newNumPages);
+	int i;
+
+	for(i = 0; i < mgmt->prefetchCount; i++)
+	{
+		newQueue[i] = mgmt->prefetchQueue[(mgmt->prefetchHead + i) % mgmt->numFrames];
+	}
+	free(mgmt->prefetchQueue);
+	mgmt->prefetchQueue = newQueue;
+	mgmt->prefetchHead = 0;
+}
+
+/*
+ * Function: resizeBufferPool
+ * ---------------------------
+ * This function changes the number of frames of a pool while it stays in use, keeping the cached pages.
+ * Growing inserts empty frames in front of mgmt->head, where isEmptyBP fills them first.
+ * Shrinking releases empty frames first, then unpinned frames in replacement order
+ * starting at mgmt->tail, writing dirty ones back. Pinned frames and frames being
+ * prefetched are never released. For a pool attached with
+ * initSharedBufferPool this resizes the global pool.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * newNumPages: Number of frames after the resize.
+ *
+ * return: RC_OK if the pool was resized.
+ *         RC_BM_INVALID_POOL_SIZE if newNumPages is not positive.
+ *         RC_BM_FRAMES_PINNED if too many frames are pinned to shrink, the pool is left unchanged.
+ *         writeBlock errors if a write back fails, the pool keeps its size then.
+ *
+ */
+
+RC resizeBufferPool(BM_BufferPool *const bm, const int newNumPages)
+{
+	BManager *mgmt = bm->mgmtData;
+	PageFrame *frame, *first = NULL, *last = NULL;
+	PageFrame **victims;
+	int i, toRemove, numVictims = 0;
+	RC writeFlag;
+
+	if(newNumPages <= 0)
+	{
+		return RC_BM_INVALID_POOL_SIZE;
+	}
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	if(newNumPages > mgmt->numFrames)
+	{
+		resizePrefetchQueue(mgmt, newNumPages);
+		//build the new frames as a chain and splice it in front of head
+		for(i = mgmt->numFrames; i < newNumPages; i++)
+		{
+			frame = (PageFrame *) calloc(1, sizeof(PageFrame));
+			frame->fileId = -1;
+			frame->pageNum = NO_PAGE;
+			frame->data = calloc(PAGE_SIZE,sizeof(char));
+			if(first == NULL)
+			{
+				first = frame;
+			}
+			else
+			{
+				last->next = frame;
+				frame->prev = last;
+			}
+			last = frame;
+		}
+		first->prev = mgmt->head->prev;
+		mgmt->head->prev->next = first;
+		last->next = mgmt->head;
+		mgmt->head->prev = last;
+		if(mgmt->tail == mgmt->head && mgmt->occupiedCount < mgmt->numFrames)
+		{
+			mgmt->tail = first;
+		}
+		mgmt->head = first;
+		mgmt->numFrames = newNumPages;
+		frameReleased(mgmt);
+	}
+	else if(newNumPages < mgmt->numFrames)
+	{
+		toRemove = mgmt->numFrames - newNumPages;
+		victims = (PageFrame **) malloc(sizeof(PageFrame *) * toRemove);
+		//empty frames go first, then unpinned ones in replacement order
+		frame = mgmt->head;
+		do
+		{
+			if(numVictims < toRemove && frame->pageNum == NO_PAGE && frame->fixCount == 0 && !frame->ioInProgress)
+			{
+				victims[numVictims++] = frame;
+			}
+			frame = frame->next;
+		}while(frame != mgmt->head);
+		frame = mgmt->tail;
+		do
+		{
+			if(numVictims < toRemove && frame->pageNum != NO_PAGE && frame->fixCount == 0 && !frame->ioInProgress)
+			{
+				victims[numVictims++] = frame;
+			}
+			frame = frame->next;
+		}while(frame != mgmt->tail);
+		if(numVictims < toRemove)
+		{
+			free(victims);
+			pthread_mutex_unlock(&mgmt->poolLock);
+			return RC_BM_FRAMES_PINNED;
+		}
+
+		//write back before anything is removed, so a failed write leaves the pool as it was
+		for(i = 0; i < numVictims; i++)
+		{
+			frame = victims[i];
+			if(frame->pageNum != NO_PAGE && frame->dirtyFlag != 0)
+			{
+				writeFlag = writeFrameToFile(mgmt, frame);
+				if(writeFlag != RC_OK)
+				{
+					free(victims);
+					pthread_mutex_unlock(&mgmt->poolLock);
+					return writeFlag;
+				}
+				frame->dirtyFlag = 0;
+				mgmt->numWrite++;
+				countEvent(mgmt, offsetof(BM_PoolStats, dirtyEvictions));
+			}
+			else if(frame->pageNum != NO_PAGE)
+			{
+				countEvent(mgmt, offsetof(BM_PoolStats, cleanEvictions));
+			}
+		}
+		//the queue is indexed modulo numFrames, copy it out while that is still the old size
+		resizePrefetchQueue(mgmt, newNumPages);
+		for(i = 0; i < numVictims; i++)
+		{
+			emptyFrame(mgmt, victims[i]);
+			unlinkFrame(mgmt, victims[i]);
+		}
+		free(victims);
+	}
+	//the statistics arrays are reallocated for the new size on their next use
+	free(mgmt->frameContent);
+	free(mgmt->dirtyBit);
+	free(mgmt->fixCount);
+	mgmt->frameContent = NULL;
+	mgmt->dirtyBit = NULL;
+	mgmt->fixCount = NULL;
+	bm->numPages = mgmt->numFrames;
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return RC_OK;
+}
+
+/*
+ * Function: cleanAheadOfEviction
+ * ---------------------------
+ * One round of the background writer. Walks the ring from the replacement hand
+ * (mgmt->tail), i.e. in the order FIFO and LRU will look for victims, and writes
+ * dirty unpinned frames until writerCleanTarget clean unpinned frames are waiting
+ * ahead of the hand or writerMaxWrites pages have been written.
+ * The pool lock is held for the whole round, so writerMaxWrites bounds how long
+ * a foreground pin can be held up by the writer.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ *
+ * return: RC_OK if the round completed.
+ *         openPageFile or writeBlock errors if a write back fails.
+ *
+ */
+
+static RC cleanAheadOfEviction(BManager *mgmt)
+{
+	SM_FileHandle fh;
+	PageFrame *frame;
+	int visited = 0, cleanCount = 0, writes = 0;
+	int openFileId = -1;
+	RC rc = RC_OK;
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	//No evictions happen while there are empty frames left
+	if(mgmt->occupiedCount < mgmt->numFrames)
+	{
+		pthread_mutex_unlock(&mgmt->poolLock);
+		return RC_OK;
+	}
+
+	frame = mgmt->tail;
+	while(visited < mgmt->numFrames && cleanCount < mgmt->writerCleanTarget)
+	{
+		if(frame->fixCount == 0 && !frame->ioInProgress)
+		{
+			if(frame->dirtyFlag == 0)
+			{
+				cleanCount++;
+			}
+			else if(writes < mgmt->writerMaxWrites)
+			{
+				//frames of the global pool belong to different files
+				if(frame->fileId != openFileId)
+				{
+					if(openFileId >= 0)
+					{
+						closePageFile(&fh);
+					}
+					openFileId = -1;
+					rc = openPageFile(mgmt->fileNames[frame->fileId], &fh);
+					if(rc != RC_OK)
+					{
+						break;
+					}
+					openFileId = frame->fileId;
+				}
+				rc = writeBlock(frame->pageNum, &fh, frame->data);
+				if(rc != RC_OK)
+				{
+					break;
+				}
+				frame->dirtyFlag = 0;
+				mgmt->numWrite++;
+				countEvent(mgmt, offsetof(BM_PoolStats, writerWrites));
+				writes++;
+				cleanCount++;
+			}
+		}
+		frame = frame->next;
+		visited++;
+	}
+
+	if(openFileId >= 0)
+	{
+		closePageFile(&fh);
+	}
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return rc;
+}
+
+/*
+ * Function: backgroundWriter
+ * ---------------------------
+ * Thread body of the background writer. Runs cleanAheadOfEviction every
+ * writerIntervalMs milliseconds until stopBackgroundWriter is called.
+ *
+ * arg: The BManager of the pool the writer was started on.
+ *
+ * return: NULL
+ *
+ */
+
+static void *backgroundWriter(void *arg)
+{
+	BManager *mgmt = (BManager *) arg;
+	struct timespec wakeUp;
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	while(mgmt->writerRunning)
+	{
+		clock_gettime(CLOCK_REALTIME, &wakeUp);
+		wakeUp.tv_sec += mgmt->writerIntervalMs / 1000;
+		wakeUp.tv_nsec += (long) (mgmt->writerIntervalMs % 1000) * 1000000L;
+		if(wakeUp.tv_nsec >= 1000000000L)
+		{
+			wakeUp.tv_sec++;
+			wakeUp.tv_nsec -= 1000000000L;
+		}
+		pthread_cond_timedwait(&mgmt->writerCond, &mgmt->poolLock, &wakeUp);
+		if(!mgmt->writerRunning)
+		{
+			break;
+		}
+		pthread_mutex_unlock(&mgmt->poolLock);
+		cleanAheadOfEviction(mgmt);
+		pthread_mutex_lock(&mgmt->poolLock);
+	}
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return NULL;
+}
+
+/*
+ * Function: startBackgroundWriter
+ * ---------------------------
+ * Starts a thread that writes dirty, unpinned frames which are close to eviction,
+ * so that pinWithFIFO/pinWithLRU find a clean victim and a miss costs a single read.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * intervalMs: Delay between two writer rounds in milliseconds.
+ * maxWritesPerRound: Upper bound of pages written per round (the write rate).
+ * cleanTarget: Number of clean unpinned frames the writer keeps ahead of the replacement hand.
+ *
+ * return: RC_OK if the writer was started.
+ *         RC_BM_WRITER_ALREADY_RUNNING if a writer is already active on this pool.
+ *         RC_BM_INVALID_WRITER_CONFIG if a parameter is not positive.
+ *
+ */
+
+RC startBackgroundWriter(BM_BufferPool *const bm, int intervalMs, int maxWritesPerRound, int cleanTarget)
+{
+	BManager *mgmt = bm->mgmtData;
+
+	if(intervalMs <= 0 || maxWritesPerRound <= 0 || cleanTarget <= 0)
+	{
+		return RC_BM_INVALID_WRITER_CONFIG;
+	}
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	if(mgmt->writerRunning)
+	{
+		pthread_mutex_unlock(&mgmt->poolLock);
+		return RC_BM_WRITER_ALREADY_RUNNING;
+	}
+	mgmt->writerIntervalMs = intervalMs;
+	mgmt->writerMaxWrites = maxWritesPerRound;
+	mgmt->writerCleanTarget = cleanTarget;
+	mgmt->writerRunning = true;
+	pthread_mutex_unlock(&mgmt->poolLock);
+
+	if(pthread_create(&mgmt->writerThread, NULL, backgroundWriter, mgmt) != 0)
+	{
+		mgmt->writerRunning = false;
+		return RC_BM_INVALID_WRITER_CONFIG;
+	}
+	return RC_OK;
+}
+
+/*
+ * Function: stopBackgroundWriter
+ * ---------------------------
+ * Stops the background writer of the pool and waits for its current round to finish.
+ * Does nothing if no writer is running.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ *
+ * return: RC_OK
+ *
+ */
+
+RC stopBackgroundWriter(BM_BufferPool *const bm)
+{
+	return stopBackgroundWriterOf(bm->mgmtData);
+}
+
+/*
+ * Function: stopBackgroundWriterOf
+ * ---------------------------
+ * Stops the background writer of a buffer manager, see stopBackgroundWriter.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ *
+ * return: RC_OK
+ *
+ */
+
+static RC stopBackgroundWriterOf(BManager *mgmt)
+{
+	pthread_mutex_lock(&mgmt->poolLock);
+	if(!mgmt->writerRunning)
+	{
+		pthread_mutex_unlock(&mgmt->poolLock);
+		return RC_OK;
+	}
+	mgmt->writerRunning = false;
+	pthread_cond_signal(&mgmt->writerCond);
+	pthread_mutex_unlock(&mgmt->poolLock);
+
+	pthread_join(mgmt->writerThread, NULL);
+	return RC_OK;
+}
+
+
+/*
+ * Function: findFrame
+ * ---------------------------
+ * This function looks up the frame holding a page, including frames whose read is still in flight.
+ *
+ * mgmt: Structure which stores information about the buffer Manager.
+ * fileId: File the page belongs to.
+ * pageNum: Page number to look for.
+ *
+ * return: the frame holding the page, NULL if the page is not in the pool.
+ *
+ */
+
+static PageFrame *findFrame(BManager *mgmt, const int fileId, const PageNumber pageNum)
+{
+	PageFrame *frame = mgmt->head;
+	do
+	{
+		if(frame->pageNum == pageNum && frame->fileId == fileId)
+		{
+			return frame;
+		}
+		frame = frame->next;
+	}while(frame != mgmt->head);
+	return NULL;
+}
+
+/*
+ * Function: claimFrameForPrefetch
+ * ---------------------------
+ * This function picks the frame a prefetched page is read into. Empty frames are used first,
+ * then clean unpinned frames starting at the replacement hand. Dirty frames are never chosen,
+ * so a prefetch never causes a write. Must be called with the pool lock held.
+ *
+ * bm: Structure which stores information about the buffer pool the page belongs to.
+ * mgmt: Structure which stores information about the buffer manager.
+ * pageNum: Page number which will be read into the frame.
+ * ring: Access strategy the frame is taken from and recorded in, or NULL.
+ *
+ * return: the claimed frame, marked as ioInProgress, or NULL if no frame is available.
+ *
+ */
+
+static PageFrame *claimFrameForPrefetch(BM_BufferPool *const bm, BManager *mgmt, const PageNumber pageNum, BM_AccessStrategy *const ring)
+{
+	PageFrame *frame = NULL;
+
+	if(ring != NULL && ring->used == ring->ringSize)
+	{
+		frame = takeRingFrame(mgmt, ring);
+	}
+	if(frame != NULL)
+	{
+		//recycled from the ring, the pool's replacement order is left alone
+	}
+	else if((frame = findEmptyFrame(mgmt)) != NULL)
+	{
+		if(frame == mgmt->head && frame->next != mgmt->head)
+		{
+			mgmt->head = frame->next;
+		}
+		mgmt->occupiedCount++;
+	}
+	else if(mgmt->waitHead != NULL)
+	{
+		//pins are waiting for a frame, read-ahead must not take it from them
+		return NULL;
+	}
+	else
+	{
+		frame = mgmt->tail;
+		while(frame->fixCount != 0 || frame->ioInProgress || frame->dirtyFlag != 0 || frame->priority == BM_PRIORITY_HOT)
+		{
+			frame = frame->next;
+			if(frame == mgmt->tail)
+			{
+				return NULL;
+			}
+		}
+		mgmt->tail = frame->next;
+		mgmt->head = frame;
+		countEvent(mgmt, offsetof(BM_PoolStats, cleanEvictions));
+	}
+
+	frame->fileId = bm->fileId;
+	frame->pageNum = pageNum;
+	frame->dirtyFlag = 0;
+	frame->ioInProgress = 1;
+	//read ahead pages nobody pinned yet are the first to go
+	frame->priority = BM_PRIORITY_SCAN;
+	if(ring != NULL)
+	{
+		recordRingFrame(ring, bm->fileId, pageNum);
+	}
+	return frame;
+}
+
+/*
+ * Function: prefetchWorker
+ * ---------------------------
+ * Thread body of the prefetch worker. Reads the queued frames and wakes up pins waiting for them.
+ * Queued frames holding consecutive pages of one file are read together with one readBlocks call,
+ * up to PREFETCH_BATCH pages. The last page file read from is kept open while the queue is non-empty.
+ * On shutdown the queue is drained before the thread exits.
+ *
+ * arg: The BManager of the pool the worker was started on.
+ *
+ * return: NULL
+ *
+ */
+
+static void *prefetchWorker(void *arg)
+{
+	BManager *mgmt = (BManager *) arg;
+	SM_FileHandle fh;
+	bool fileOpen = false;
+	int openFileId = -1;
+	char *fileName;
+	PageFrame *frame;
+	PageFrame *batch[PREFETCH_BATCH];
+	SM_PageHandle batchPages[PREFETCH_BATCH];
+	PageNumber pageNum;
+	int fileId, batchSize, i;
+	RC readFlag;
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	while(true)
+	{
+		while(mgmt->prefetchCount == 0 && mgmt->prefetchRunning)
+		{
+			if(fileOpen)
+			{
+				closePageFile(&fh);
+				fileOpen = false;
+			}
+			pthread_cond_wait(&mgmt->ioCond, &mgmt->poolLock);
+		}
+		if(mgmt->prefetchCount == 0)
+		{
+			break;
+		}
+
+		frame = mgmt->prefetchQueue[mgmt->prefetchHead];
+		mgmt->prefetchHead = (mgmt->prefetchHead + 1) % mgmt->numFrames;
+		mgmt->prefetchCount--;
+		pageNum = frame->pageNum;
+		fileId = frame->fileId;
+		fileName = mgmt->fileNames[fileId];
+		batch[0] = frame;
+		batchPages[0] = frame->data;
+		batchSize = 1;
+		//take the following queue entries along while they continue the run
+		while(batchSize < PREFETCH_BATCH && mgmt->prefetchCount > 0)
+		{
+			frame = mgmt->prefetchQueue[mgmt->prefetchHead];
+			if(frame->fileId != fileId || frame->pageNum != pageNum + batchSize)
+			{
+				break;
+			}
+			mgmt->prefetchHead = (mgmt->prefetchHead + 1) % mgmt->numFrames;
+			mgmt->prefetchCount--;
+			batch[batchSize] = frame;
+			batchPages[batchSize] = frame->data;
+			batchSize++;
+		}
+		pthread_mutex_unlock(&mgmt->poolLock);
+
+		//the frame is claimed, nobody else touches its data until ioInProgress is cleared
+		if(fileOpen && openFileId != fileId)
+		{
+			closePageFile(&fh);
+			fileOpen = false;
+		}
+		if(!fileOpen && openPageFile(fileName, &fh) == RC_OK)
+		{
+			//unbuffered, so pages written through other handles are never read stale
+			setvbuf(fh.mgmtInfo, NULL, _IONBF, 0);
+			fileOpen = true;
+			openFileId = fileId;
+		}
+		readFlag = fileOpen ? readBlocks(pageNum, batchSize, &fh, batchPages) : RC_FILE_NOT_FOUND;
+
+		pthread_mutex_lock(&mgmt->poolLock);
+		for(i = 0; i < batchSize; i++)
+		{
+			frame = batch[i];
+			if(readFlag == RC_OK)
+			{
+				mgmt->numRead++;
+				countEvent(mgmt, offsetof(BM_PoolStats, prefetchReads));
+			}
+			frame->ioInProgress = 0;
+			if(readFlag != RC_OK)
+			{
+				emptyFrame(mgmt, frame);
+			}
+		}
+		frameReleased(mgmt);
+		pthread_cond_broadcast(&mgmt->ioDoneCond);
+	}
+	if(fileOpen)
+	{
+		closePageFile(&fh);
+	}
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return NULL;
+}
+
+/*
+ * Function: startPrefetch
+ * ---------------------------
+ * Shared implementation of prefetchPages and prefetchPageRange. Claims a frame for every page
+ * which is neither in the pool nor beyond the end of the file, queues its read and returns.
+ * Prefetching stops early when no clean frame is left.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * pageNums: Pages to prefetch, or NULL to prefetch firstPage .. firstPage+n-1.
+ * firstPage: First page of the range if pageNums is NULL.
+ * n: Number of pages.
+ * ring: Access strategy the frames are taken from, or NULL.
+ *
+ * return: RC_OK if the reads were queued.
+ *         RC_FILE_NOT_FOUND if the page file cannot be opened.
+ *
+ */
+
+static RC startPrefetch(BM_BufferPool *const bm, const PageNumber *pageNums, const PageNumber firstPage, const int n, BM_AccessStrategy *const ring)
+{
+	BManager *mgmt = bm->mgmtData;
+	SM_FileHandle fh;
+	PageFrame *frame;
+	PageNumber pageNum;
+	int i, tail;
+
+	if(openPageFile((char *)(bm->pageFile), &fh) != RC_OK)
+	{
+		return RC_FILE_NOT_FOUND;
+	}
+	closePageFile(&fh);
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	if(!mgmt->prefetchRunning)
+	{
+		mgmt->prefetchRunning = true;
+		pthread_create(&mgmt->prefetchThread, NULL, prefetchWorker, mgmt);
+	}
+
+	for(i = 0; i < n; i++)
+	{
+		pageNum = (pageNums != NULL) ? pageNums[i] : firstPage + i;
+		if(pageNum < 0 || pageNum >= fh.totalNumPages || findFrame(mgmt, bm->fileId, pageNum) != NULL)
+		{
+			continue;
+		}
+		frame = claimFrameForPrefetch(bm, mgmt, pageNum, ring);
+		if(frame == NULL)
+		{
+			break;
+		}
+		tail = (mgmt->prefetchHead + mgmt->prefetchCount) % mgmt->numFrames;
+		mgmt->prefetchQueue[tail] = frame;
+		mgmt->prefetchCount++;
+	}
+
+	pthread_cond_signal(&mgmt->ioCond);
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return RC_OK;
+}
+
+/*
+ * Function: prefetchPages
+ * ---------------------------
+ * Starts asynchronous reads of the given pages into free or evictable frames without pinning them
+ * and returns immediately. A later pinPage of a page still in flight waits for that read.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * pageNums: Pages which will be needed soon.
+ * n: Number of entries in pageNums.
+ *
+ * return: RC_OK if the reads were queued.
+ *         RC_FILE_NOT_FOUND if the page file cannot be opened.
+ *
+ */
+
+RC prefetchPages(BM_BufferPool *const bm, const PageNumber *pageNums, const int n)
+{
+	return startPrefetch(bm, pageNums, NO_PAGE, n, NULL);
+}
+
+/*
+ * Function: prefetchPageRange
+ * ---------------------------
+ * Range variant of prefetchPages for the pages firstPage .. firstPage+n-1.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * firstPage: First page of the range.
+ * n: Number of pages in the range.
+ *
+ * return: RC_OK if the reads were queued.
+ *         RC_FILE_NOT_FOUND if the page file cannot be opened.
+ *
+ */
+
+RC prefetchPageRange(BM_BufferPool *const bm, const PageNumber firstPage, const int n)
+{
+	return startPrefetch(bm, NULL, firstPage, n, NULL);
+}
+
+/*
+ * Function: prefetchPageRangeWithStrategy
+ * ---------------------------
+ * Variant of prefetchPageRange taking its frames from an access strategy's ring,
+ * for scans which read ahead and pin through pinPageWithStrategy.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * firstPage: First page of the range.
+ * n: Number of pages in the range.
+ * ring: Access strategy of the caller.
+ *
+ * return: RC_OK if the reads were queued.
+ *         RC_FILE_NOT_FOUND if the page file cannot be opened.
+ *
+ */
+
+RC prefetchPageRangeWithStrategy(BM_BufferPool *const bm, const PageNumber firstPage, const int n, BM_AccessStrategy *const ring)
+{
+	return startPrefetch(bm, NULL, firstPage, n, ring);
+}
+
+/*
+ * Function: setBufferPoolWarmup
+ * ---------------------------
+ * Switches pool warm-up on or off for the process. While it is on, shutdownBufferPool writes
+ * the pages of the page file still resident in the pool, in replacement order, to a sidecar
+ * file named after the page file with WARMUP_SUFFIX appended. initBufferPool and initSharedBufferPool
+ * read that list back, remove the sidecar so that a later restart never loads a stale list, and
+ * prefetch the pages in the background, so a restarted pool serves pins while it fills up with
+ * its previous working set. destroyPageFile removes the sidecar along with the page file.
+ *
+ * enabled: true to dump and reload resident pages.
+ *
+ * return: RC_OK
+ *
+ */
+
+RC setBufferPoolWarmup(bool enabled)
+{
+	warmupEnabled = enabled;
+	return RC_OK;
+}
+
+/*
+ * Function: warmupFileName
+ * ---------------------------
+ * Returns the name of the warm-up sidecar of a page file, the caller frees it.
+ *
+ * pageFileName: Name of the page file.
+ *
+ * return: the sidecar file name
+ *
+ */
+
+static char *warmupFileName(const char *pageFileName)
+{
+	char *name = (char *) malloc(strlen(pageFileName) + strlen(WARMUP_SUFFIX) + 1);
+	sprintf(name, "%s%s", pageFileName, WARMUP_SUFFIX);
+	return name;
+}
 
- /*
-  * Function: pinWithLRU
-  * ---------------------------
-  * This function implements Least Recently Used Algorithm for page replacement
-  *
-  * bm: Structure which stores information about the buffer pool.
-  * page: Structure which stores information about buffer page handle.
-  * pageNum: This is a field in buffer page handle which stored the page number.
-  * mgmt: Structure which stores information about the buffer manager.
-  * frame: Structure which stores information about the buffer frame.
-  * fh: Structure which holds Filehandler.
-  *
-  * return: RC_OK if the page pinning to the buffer pool is successful.
-  *				 RC_IM_KEY_NOT_FOUND if page is not found in buffer.
-  *				 readBlock or writeBlock errors if the operations fail.
-  *
-  *
-  */
+/*
+ * Function: dumpResidentPages
+ * ---------------------------
+ * Writes the page numbers of bm's file held by the pool to the warm-up sidecar, starting at the
+ * replacement hand so that the pages evicted first come first. The sidecar holds the number of
+ * pages followed by the page numbers, as ints. Must be called with the pool lock held.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * mgmt: Structure which stores information about the buffer manager.
+ *
+ * return: void
+ *
+ */
 
- RC pinWithLRU(BM_BufferPool *const bm, BM_PageHandle *const page,const PageNumber pageNum,BManager *mgmt, SM_FileHandle fh)
- {
-	 PageFrame *frame = mgmt->head;
+static void dumpResidentPages(BM_BufferPool *const bm, BManager *mgmt)
+{
+	PageNumber *pageNums;
+	PageFrame *frame = mgmt->tail;
+	char *sidecar;
+	FILE *fptr;
+	int i, count = 0;
 
-  if(mgmt->occupiedCount < bm->numPages)
-  {
- 	 isEmptyBP(bm,pageNum);
- 	 printf("Inserting remaining frames in empty spaces in buffer pool with LRU");
-  }
-  else
-  {
- 	 frame = mgmt->tail;
- 	 do
- 	 {
- 		 if(frame->fixCount == 0)
- 		 {
- 			 //If dirty then write back to disc using writeBlock function
- 			 if(frame->dirtyFlag != 0)
- 			 {
- 				 ensureCapacity(frame->pageNum, &fh);
- 				 RC writeFlag = writeBlock(frame->pageNum,&fh, frame->data);
- 				 if(writeFlag!=RC_OK)
- 				 {
- 					 closePageFile(&fh);
- 					 return writeFlag;
- 				 }
- 				 else{
- 					 mgmt->numWrite++;
- 				 }
+	if(!warmupEnabled)
+	{
+		return;
+	}
+	pageNums = (PageNumber *) malloc(sizeof(PageNumber) * mgmt->numFrames);
+	for(i = 0; i < mgmt->numFrames; i++)
+	{
+		if(frame->fileId == bm->fileId && frame->pageNum != NO_PAGE && !frame->ioInProgress)
+		{
+			pageNums[count++] = frame->pageNum;
+		}
+		frame = frame->next;
+	}
+	sidecar = warmupFileName(bm->pageFile);
+	fptr = fopen(sidecar, "wb");
+	if(fptr != NULL)
+	{
+		fwrite(&count, sizeof(int), 1, fptr);
+		fwrite(pageNums, sizeof(PageNumber), count, fptr);
+		fclose(fptr);
+	}
+	free(sidecar);
+	free(pageNums);
+}
 
- 			 }
+/*
+ * Function: comparePageNums
+ * ---------------------------
+ * qsort comparator for page numbers.
+ *
+ * a, b: Pointers to the two page numbers.
+ *
+ * return: <0, 0 or >0 like strcmp.
+ *
+ */
 
- 			 //Replacing the page which is least recently used.
- 			 if(mgmt->tail == mgmt->head)
- 			 {
- 				 frame = frame->next;
- 				 frame->pageNum = pageNum;
- 				 frame->fixCount++;
- 				 mgmt->tail = frame;
- 				 mgmt->head = frame;
- 				 mgmt->tail = frame->prev;
- 				 break;
- 			 }
- 			 else
- 			 {
- 				 frame->pageNum = pageNum;
- 				 frame->fixCount++;
- 				 //mgmt->tail = frame->next;
- 				 mgmt->tail = frame;
- 				 mgmt->tail = frame->next;
- 				 break;
- 			 }
- 		 }
- 		 else
- 		 {
- 			 frame = frame->next;
- 		 }
- 	 }while(frame!= mgmt->tail);
-  }
-  //Add pages if not sufficient
-  ensureCapacity((pageNum+1),&fh);
-  RC readFlag = readBlock(pageNum, &fh,frame->data);
-  if(readFlag!=RC_OK)
-  {
- 	 return readFlag;
-  }
-  else{
- 	 mgmt->numRead++;
-  }
+static int comparePageNums(const void *a, const void *b)
+{
+	return *(const PageNumber *) a - *(const PageNumber *) b;
+}
 
-  page->pageNum = pageNum;
-  page->data = frame->data;
+/*
+ * Function: warmUpPool
+ * ---------------------------
+ * Reads the warm-up sidecar of bm's page file, if there is one, removes it and prefetches the listed pages.
+ * When the list is longer than the pool, the pages evicted last are kept. The pages are
+ * sorted so that the prefetch worker reads them in long runs.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ *
+ * return: void
+ *
+ */
 
+static void warmUpPool(BM_BufferPool *const bm)
+{
+	PageNumber *pageNums = NULL;
+	char *sidecar;
+	FILE *fptr;
+	int count = 0, keep;
 
-  closePageFile(&fh);
+	if(!warmupEnabled)
+	{
+		return;
+	}
+	sidecar = warmupFileName(bm->pageFile);
+	fptr = fopen(sidecar, "rb");
+	if(fptr == NULL)
+	{
+		free(sidecar);
+		return;
+	}
+	if(fread(&count, sizeof(int), 1, fptr) == 1 && count > 0)
+	{
+		pageNums = (PageNumber *) malloc(sizeof(PageNumber) * count);
+		count = fread(pageNums, sizeof(PageNumber), count, fptr);
+	}
+	else
+	{
+		count = 0;
+	}
+	fclose(fptr);
+	//the list is in the pool now, the next shutdown writes a current one
+	remove(sidecar);
+	free(sidecar);
+	if(count == 0)
+	{
+		free(pageNums);
+		return;
+	}
 
-  return RC_OK;
- }
+	keep = (count < bm->numPages) ? count : bm->numPages;
+	qsort(pageNums + count - keep, keep, sizeof(PageNumber), comparePageNums);
+	prefetchPages(bm, pageNums + count - keep, keep);
+	free(pageNums);
+}
 
+/*
+ * Function: stopPrefetchWorkerOf
+ * ---------------------------
+ * Stops the prefetch worker of a buffer manager after the reads already queued have completed.
+ *
+ * mgmt: Structure which stores information about the buffer manager.
+ *
+ * return: RC_OK
+ *
+ */
 
+static RC stopPrefetchWorkerOf(BManager *mgmt)
+{
+	pthread_mutex_lock(&mgmt->poolLock);
+	if(!mgmt->prefetchRunning)
+	{
+		pthread_mutex_unlock(&mgmt->poolLock);
+		return RC_OK;
+	}
+	mgmt->prefetchRunning = false;
+	pthread_cond_signal(&mgmt->ioCond);
+	pthread_mutex_unlock(&mgmt->poolLock);
 
+	pthread_join(mgmt->prefetchThread, NULL);
+	return RC_OK;
+}
 
 // Statistics Interface
 /*
  * The getFrameContents function returns an array of PageNumbers (of size numPages)
  * where the ith element is the number of the page stored in the ith page frame.
  * An empty page frame is represented using the constant NO_PAGE.
+ * The array belongs to the pool and is overwritten by the next call,
+ * it stays valid until the pool is resized or shut down.
  */
 PageNumber *getFrameContents (BM_BufferPool *const bm)
 {
 	BManager *bp_mgmt;
 	bp_mgmt = bm->mgmtData;
-	bp_mgmt->frameContent = (PageNumber*)malloc(sizeof(PageNumber)*bm->numPages);
+	pthread_mutex_lock(&bp_mgmt->poolLock);
+	bm->numPages = bp_mgmt->numFrames;
+	if(bp_mgmt->frameContent == NULL)
+	{
+		bp_mgmt->frameContent = (PageNumber*)malloc(sizeof(PageNumber)*bm->numPages);
+	}
 
 	PageFrame *frame = bp_mgmt->start;
 	PageNumber* frameContents = bp_mgmt->frameContent;
@@ -641,7 +3046,7 @@ PageNumber *getFrameContents (BM_BufferPool *const bm)
 			frame = frame->next;
 		}
 	}
-	//free(bp_mgmt->frameContent);
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
 
 	return frameContents;
 }
@@ -650,12 +3055,18 @@ PageNumber *getFrameContents (BM_BufferPool *const bm)
  * The getDirtyFlags function returns an array of bools (of size numPages)
  * where the ith element is TRUE if the page stored in the ith page frame is dirty.
  * Empty page frames are considered as clean.
+ * The array belongs to the pool, see getFrameContents.
  */
 bool *getDirtyFlags (BM_BufferPool *const bm)
 {
 	BManager *bp_mgmt;
 	bp_mgmt = bm->mgmtData;
-	bp_mgmt->dirtyBit = (bool*)malloc(sizeof(bool)*bm->numPages);
+	pthread_mutex_lock(&bp_mgmt->poolLock);
+	bm->numPages = bp_mgmt->numFrames;
+	if(bp_mgmt->dirtyBit == NULL)
+	{
+		bp_mgmt->dirtyBit = (bool*)malloc(sizeof(bool)*bm->numPages);
+	}
 
 	PageFrame *frame = bp_mgmt->start;
 	bool* dirtyBit = bp_mgmt->dirtyBit;
@@ -670,7 +3081,7 @@ bool *getDirtyFlags (BM_BufferPool *const bm)
 			frame = frame->next;
 		}
 	}
-	//free(bp_mgmt->dirtyBit);
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
 
 	return dirtyBit;
 }
@@ -679,12 +3090,18 @@ bool *getDirtyFlags (BM_BufferPool *const bm)
  * The getFixCounts function returns an array of ints (of size numPages)
  * where the ith element is the fix count of the page stored in the ith page frame.
  * Return 0 for empty page frames.
+ * The array belongs to the pool, see getFrameContents.
  */
 int *getFixCounts (BM_BufferPool *const bm)
 {
 	BManager *bp_mgmt;
 	bp_mgmt = bm->mgmtData;
-	bp_mgmt->fixCount = (int*)malloc(sizeof(int)*bm->numPages);
+	pthread_mutex_lock(&bp_mgmt->poolLock);
+	bm->numPages = bp_mgmt->numFrames;
+	if(bp_mgmt->fixCount == NULL)
+	{
+		bp_mgmt->fixCount = (int*)malloc(sizeof(int)*bm->numPages);
+	}
 
 	PageFrame *frame = bp_mgmt->start;
 	int* fixCount = bp_mgmt->fixCount;
@@ -699,7 +3116,7 @@ int *getFixCounts (BM_BufferPool *const bm)
 			frame = frame->next;
 		}
 	}
-	//free(bp_mgmt->fixCount);
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
 
 	return  fixCount;
 }
@@ -709,7 +3126,12 @@ int *getFixCounts (BM_BufferPool *const bm)
  */
 int getNumReadIO (BM_BufferPool *const bm)
 {
-	return ((BManager*)bm->mgmtData)->numRead;
+	BManager *bp_mgmt = bm->mgmtData;
+	int count;
+	pthread_mutex_lock(&bp_mgmt->poolLock);
+	count = bp_mgmt->numRead;
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
+	return count;
 }
 
 /*
@@ -717,5 +3139,207 @@ int getNumReadIO (BM_BufferPool *const bm)
  */
 int getNumWriteIO (BM_BufferPool *const bm)
 {
-	return ((BManager*)bm->mgmtData)->numWrite;
+	BManager *bp_mgmt = bm->mgmtData;
+	int count;
+	pthread_mutex_lock(&bp_mgmt->poolLock);
+	count = bp_mgmt->numWrite;
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
+	return count;
+}
+
+/*
+ * This function gets the number of dirty pages of the pool's page file, pinned dirty pages
+ * included, which forceFlushPool passes over
+ */
+int getNumDirtyPages (BM_BufferPool *const bm)
+{
+	BManager *bp_mgmt = bm->mgmtData;
+	PageFrame *frame;
+	int count = 0;
+	pthread_mutex_lock(&bp_mgmt->poolLock);
+	frame = bp_mgmt->head;
+	do
+	{
+		if(frame->fileId == bm->fileId && frame->dirtyFlag != 0)
+		{
+			count++;
+		}
+		frame = frame->next;
+	}while(frame != bp_mgmt->head);
+	pthread_mutex_unlock(&bp_mgmt->poolLock);
+	return count;
+}
+
+/*
+ * Function: getPoolStats
+ * ---------------------------
+ * Copies the event counters of a pool into a caller supplied structure. For a pool attached
+ * with initSharedBufferPool these are the counters of the global pool.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * stats: Receives the counters.
+ *
+ * return: RC_OK
+ *
+ */
+
+RC getPoolStats(BM_BufferPool *const bm, BM_PoolStats *stats)
+{
+	BManager *mgmt = bm->mgmtData;
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	*stats = mgmt->stats;
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return RC_OK;
+}
+
+/*
+ * Function: resetPoolStats
+ * ---------------------------
+ * Sets the event counters of a pool back to zero. The strategy totals and the read/write IO
+ * counts are not affected.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ *
+ * return: RC_OK
+ *
+ */
+
+RC resetPoolStats(BM_BufferPool *const bm)
+{
+	BManager *mgmt = bm->mgmtData;
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	memset(&mgmt->stats, 0, sizeof(BM_PoolStats));
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return RC_OK;
+}
+
+/*
+ * Function: getStrategyStats
+ * ---------------------------
+ * Copies the event counters summed over every pool, open or shut down, using a replacement strategy.
+ *
+ * strategy: The replacement strategy.
+ * stats: Receives the counters.
+ *
+ * return: RC_OK
+ *         RC_BM_UNKNOWN_STRATEGY if strategy is not a ReplacementStrategy.
+ *
+ */
+
+RC getStrategyStats(ReplacementStrategy strategy, BM_PoolStats *stats)
+{
+	size_t counter;
+
+	if(strategy < RS_FIFO || strategy > RS_LRU_K)
+	{
+		return RC_BM_UNKNOWN_STRATEGY;
+	}
+	for(counter = 0; counter < sizeof(BM_PoolStats); counter += sizeof(long))
+	{
+		*(long *) ((char *) stats + counter) = __atomic_load_n(STRATEGY_COUNTER(strategy, counter), __ATOMIC_RELAXED);
+	}
+	return RC_OK;
+}
+
+/*
+ * Function: resetStrategyStats
+ * ---------------------------
+ * Sets the totals of a replacement strategy back to zero.
+ *
+ * strategy: The replacement strategy.
+ *
+ * return: RC_OK
+ *         RC_BM_UNKNOWN_STRATEGY if strategy is not a ReplacementStrategy.
+ *
+ */
+
+RC resetStrategyStats(ReplacementStrategy strategy)
+{
+	size_t counter;
+
+	if(strategy < RS_FIFO || strategy > RS_LRU_K)
+	{
+		return RC_BM_UNKNOWN_STRATEGY;
+	}
+	for(counter = 0; counter < sizeof(BM_PoolStats); counter += sizeof(long))
+	{
+		__atomic_store_n(STRATEGY_COUNTER(strategy, counter), 0, __ATOMIC_RELAXED);
+	}
+	return RC_OK;
+}
+
+/*
+ * Function: startBufferTrace
+ * ---------------------------
+ * Starts recording every pin, unpin and markDirty of the pool to a binary trace file,
+ * a BM_TraceHeader followed by one BM_TraceRecord per call. A shared pool records the calls
+ * of all its files. The trace can be replayed against other strategies and sizes with buffer_sim.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ * traceFileName: File the trace is written to, overwritten if it exists.
+ *
+ * return: RC_OK if tracing started.
+ *         RC_BM_TRACE_ALREADY_RUNNING if the pool is traced already.
+ *         RC_WRITE_FAILED if the trace file cannot be created.
+ *
+ */
+
+RC startBufferTrace(BM_BufferPool *const bm, const char *traceFileName)
+{
+	BManager *mgmt = bm->mgmtData;
+	BM_TraceHeader header;
+	FILE *file;
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	if(mgmt->traceFile != NULL)
+	{
+		pthread_mutex_unlock(&mgmt->poolLock);
+		return RC_BM_TRACE_ALREADY_RUNNING;
+	}
+	file = fopen(traceFileName, "wb");
+	if(file == NULL)
+	{
+		pthread_mutex_unlock(&mgmt->poolLock);
+		return RC_WRITE_FAILED;
+	}
+	memcpy(header.magic, BM_TRACE_MAGIC, sizeof(header.magic));
+	header.numFrames = mgmt->numFrames;
+	header.strategy = mgmt->strategy;
+	fwrite(&header, sizeof(BM_TraceHeader), 1, file);
+	gettimeofday(&mgmt->traceLast, NULL);
+	mgmt->traceFile = file;
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return RC_OK;
+}
+
+/*
+ * Function: stopBufferTrace
+ * ---------------------------
+ * Stops recording and closes the trace file. Shutting the pool down does the same.
+ *
+ * bm: Structure which stores information about the buffer pool.
+ *
+ * return: RC_OK also if the pool was not traced.
+ *         RC_WRITE_FAILED if the last records could not be written.
+ *
+ */
+
+RC stopBufferTrace(BM_BufferPool *const bm)
+{
+	BManager *mgmt = bm->mgmtData;
+	RC rc = RC_OK;
+
+	pthread_mutex_lock(&mgmt->poolLock);
+	if(mgmt->traceFile != NULL)
+	{
+		if(fclose(mgmt->traceFile) != 0)
+		{
+			rc = RC_WRITE_FAILED;
+		}
+		mgmt->traceFile = NULL;
+	}
+	pthread_mutex_unlock(&mgmt->poolLock);
+	return rc;
 }
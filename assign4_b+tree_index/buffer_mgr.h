@@ -16,23 +16,79 @@ typedef enum ReplacementStrategy {
 	RS_LRU_K = 4
 } ReplacementStrategy;
 
+// Priority classes of pinned pages, see pinPageWithPriority
+typedef enum BM_PinPriority {
+	BM_PRIORITY_NORMAL = 0,
+	BM_PRIORITY_HOT = 1, // index inner nodes, catalog pages
+	BM_PRIORITY_SCAN = 2 // pages read once
+} BM_PinPriority;
+
 // Data Types and Structures
 typedef int PageNumber;
 #define NO_PAGE -1
 
 typedef struct BM_BufferPool {
 	char *pageFile;
+	int fileId; // id of pageFile inside the pool, frames are keyed by (fileId, pageNum)
 	int numPages;
 	ReplacementStrategy strategy;
 	void *mgmtData; // use this one to store the bookkeeping info your buffer
 	// manager needs for a buffer pool
 } BM_BufferPool;
 
+// Event counters of a pool, see getPoolStats and getStrategyStats
+typedef struct BM_PoolStats {
+	long hits; // pins served from a frame
+	long misses; // pins which had to read the page
+	long cleanEvictions; // victims dropped without a write
+	long dirtyEvictions; // victims written back before reuse
+	long forcedWrites; // writes by forcePage
+	long flushWrites; // writes by forceFlushPool and pool shutdown
+	long writerWrites; // writes by the background writer
+	long prefetchReads; // reads by the prefetch worker
+	long waits; // pins which waited for a read in flight
+	long ringReuses; // misses served by recycling an access strategy's frame
+	long pinWaits; // misses which found every frame pinned
+	long pinWaitTimeouts; // of those, pins which gave up with RC_BM_PIN_TIMEOUT
+	long pinWaitMicros; // total time pins spent waiting for a frame
+} BM_PoolStats;
+
 typedef struct BM_PageHandle {
 	PageNumber pageNum;
 	char *data;
 } BM_PageHandle;
 
+// Ring of frames recycled by a scan or bulk load, see initAccessStrategy
+typedef struct BM_AccessStrategy {
+	int ringSize;
+	int used; // slots filled so far
+	int nextSlot; // slot recycled by the next miss once the ring is full
+	int *fileIds;
+	PageNumber *pageNums;
+} BM_AccessStrategy;
+
+// Trace of pool calls, see startBufferTrace
+#define BM_TRACE_MAGIC "BMT1"
+
+typedef enum BM_TraceOp {
+	BM_TRACE_PIN = 1,
+	BM_TRACE_UNPIN = 2,
+	BM_TRACE_DIRTY = 3
+} BM_TraceOp;
+
+typedef struct BM_TraceHeader {
+	char magic[4]; // BM_TRACE_MAGIC
+	int numFrames; // size of the traced pool
+	int strategy; // ReplacementStrategy of the traced pool
+} BM_TraceHeader;
+
+typedef struct BM_TraceRecord {
+	unsigned int deltaMicros; // time since the previous record
+	int fileId;
+	PageNumber pageNum;
+	int op; // BM_TraceOp
+} BM_TraceRecord;
+
 // convenience macros
 #define MAKE_POOL()					\
 		((BM_BufferPool *) malloc (sizeof(BM_BufferPool)))
@@ -45,7 +101,19 @@ RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName,
 		const int numPages, ReplacementStrategy strategy,
 		void *stratData);
 RC shutdownBufferPool(BM_BufferPool *const bm);
+
+// Global buffer pool shared by all page files
+RC initGlobalBufferPool(const int numPages, ReplacementStrategy strategy,
+		void *stratData);
+RC initSharedBufferPool(BM_BufferPool *const bm, const char *const pageFileName);
+RC shutdownGlobalBufferPool(void);
 RC forceFlushPool(BM_BufferPool *const bm);
+RC resizeBufferPool(BM_BufferPool *const bm, const int newNumPages);
+
+// Background writer
+RC startBackgroundWriter(BM_BufferPool *const bm, int intervalMs,
+		int maxWritesPerRound, int cleanTarget);
+RC stopBackgroundWriter(BM_BufferPool *const bm);
 
 // Buffer Manager Interface Access Pages
 RC markDirty (BM_BufferPool *const bm, BM_PageHandle *const page);
@@ -53,6 +121,32 @@ RC unpinPage (BM_BufferPool *const bm, BM_PageHandle *const page);
 RC forcePage (BM_BufferPool *const bm, BM_PageHandle *const page);
 RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page, 
 		const PageNumber pageNum);
+RC pinPages (BM_BufferPool *const bm, BM_PageHandle *const pages,
+		const PageNumber *pageNums, const int n);
+RC setPinWaitTimeout (BM_BufferPool *const bm, int timeoutMs);
+RC pinPageWithPriority (BM_BufferPool *const bm, BM_PageHandle *const page,
+		const PageNumber pageNum, BM_PinPriority priority);
+
+// Ring access strategy for pages read once
+RC initAccessStrategy (BM_AccessStrategy *const ring, const int ringSize);
+RC freeAccessStrategy (BM_AccessStrategy *const ring);
+RC pinPageWithStrategy (BM_BufferPool *const bm, BM_PageHandle *const page,
+		const PageNumber pageNum, BM_AccessStrategy *const ring);
+
+// Asynchronous prefetch
+RC prefetchPages (BM_BufferPool *const bm, const PageNumber *pageNums,
+		const int n);
+RC prefetchPageRange (BM_BufferPool *const bm, const PageNumber firstPage,
+		const int n);
+RC prefetchPageRangeWithStrategy (BM_BufferPool *const bm,
+		const PageNumber firstPage, const int n, BM_AccessStrategy *const ring);
+
+// Warm-up of restarted pools
+RC setBufferPoolWarmup (bool enabled);
+
+// Trace capture for the buffer_sim policy simulator
+RC startBufferTrace (BM_BufferPool *const bm, const char *traceFileName);
+RC stopBufferTrace (BM_BufferPool *const bm);
 
 // Statistics Interface
 PageNumber *getFrameContents (BM_BufferPool *const bm);
@@ -60,5 +154,10 @@ bool *getDirtyFlags (BM_BufferPool *const bm);
 int *getFixCounts (BM_BufferPool *const bm);
 int getNumReadIO (BM_BufferPool *const bm);
 int getNumWriteIO (BM_BufferPool *const bm);
+int getNumDirtyPages (BM_BufferPool *const bm);
+RC getPoolStats (BM_BufferPool *const bm, BM_PoolStats *stats);
+RC resetPoolStats (BM_BufferPool *const bm);
+RC getStrategyStats (ReplacementStrategy strategy, BM_PoolStats *stats);
+RC resetStrategyStats (ReplacementStrategy strategy);
 
 #endif
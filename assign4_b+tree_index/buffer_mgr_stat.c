@@ -50,6 +50,26 @@ sprintPoolContent (BM_BufferPool *const bm)
 	return message;
 }
 
+void
+printPoolStats (BM_BufferPool *const bm)
+{
+	BM_PoolStats stats;
+	long pins;
+
+	getPoolStats(bm, &stats);
+	pins = stats.hits + stats.misses;
+
+	printf("{");
+	printStrat(bm);
+	printf(" %i}: ", bm->numPages);
+	printf("hits=%ld misses=%ld hitRatio=%.3f ", stats.hits, stats.misses,
+			(pins == 0) ? 0.0 : (double) stats.hits / pins);
+	printf("evictions(clean=%ld dirty=%ld) ", stats.cleanEvictions, stats.dirtyEvictions);
+	printf("writes(forced=%ld flush=%ld writer=%ld) ", stats.forcedWrites, stats.flushWrites, stats.writerWrites);
+	printf("prefetched=%ld waits=%ld ringReuses=%ld ", stats.prefetchReads, stats.waits, stats.ringReuses);
+	printf("pinWaits=%ld timeouts=%ld waitedMs=%ld\n", stats.pinWaits, stats.pinWaitTimeouts, stats.pinWaitMicros / 1000);
+}
+
 
 void
 printPageContent (BM_PageHandle *const page)
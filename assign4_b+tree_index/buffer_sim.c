@@ -0,0 +1,700 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "buffer_mgr.h"
+
+/*Offline buffer replacement simulator.
+	Replays a trace written by startBufferTrace against FIFO, LRU, CLOCK, LRU-2, LFU and ARC
+	at several pool sizes and prints hit ratio and write-back curves.
+
+	usage: buffer_sim traceFile [numFrames ...]
+	Without sizes the pool is simulated at 1, 2, 4, ... frames up to the number of distinct pages.
+
+	Pages are (file id, page number) pairs renumbered 0..numPages-1. Pins and unpins are
+	not modelled, any resident page can be evicted.*/
+
+#define DEFAULT_MAX_SIZES 32
+
+//A trace reduced to what the simulation needs
+typedef struct SimTrace
+{
+	int numRefs;
+	int numPages;
+	int *pages; // renumbered page of each pin or markDirty
+	char *dirty; // 1 if the event is a markDirty, 0 for a pin
+	int numPins;
+	int numFrames; // size of the traced pool
+	int strategy;
+	double seconds;
+}SimTrace;
+
+//Replacement policy: access returns the evicted page, or -1 if nothing was evicted.
+typedef struct SimPolicy
+{
+	const char *name;
+	void *(*create)(int numFrames, int numPages);
+	int (*access)(void *state, int page, int hit);
+	void (*destroy)(void *state);
+}SimPolicy;
+
+/*
+ * Function: lookupPage
+ * ---------------------------
+ * Renumbers a (file id, page number) pair with an open addressing hash table.
+ *
+ * keys: Hash table of pairs, two ints per slot, file id -1 marks a free slot.
+ * ids: Renumbered page of each slot.
+ * capacity: Number of slots, a power of two.
+ * fileId, pageNum: The page.
+ * numPages: Number of pages renumbered so far, incremented for a new page.
+ *
+ * return: the renumbered page.
+ *
+ */
+
+static int lookupPage(int *keys, int *ids, int capacity, int fileId, int pageNum, int *numPages)
+{
+	unsigned int slot = ((unsigned int) fileId * 2654435761U ^ (unsigned int) pageNum * 40503U) & (capacity - 1);
+
+	while(keys[2 * slot] != -1)
+	{
+		if(keys[2 * slot] == fileId && keys[2 * slot + 1] == pageNum)
+		{
+			return ids[slot];
+		}
+		slot = (slot + 1) & (capacity - 1);
+	}
+	keys[2 * slot] = fileId;
+	keys[2 * slot + 1] = pageNum;
+	ids[slot] = (*numPages)++;
+	return ids[slot];
+}
+
+/*
+ * Function: loadTrace
+ * ---------------------------
+ * Reads a trace file written by startBufferTrace. Unpins are dropped.
+ *
+ * fileName: The trace file.
+ * trace: Receives the trace.
+ *
+ * return: 0 if the trace was read, -1 if the file is missing or no trace.
+ *
+ */
+
+static int loadTrace(const char *fileName, SimTrace *trace)
+{
+	FILE *file = fopen(fileName, "rb");
+	BM_TraceHeader header;
+	BM_TraceRecord record;
+	int *keys, *ids;
+	int capacity = 1024, allocated = 1024;
+	long long micros = 0;
+
+	if(file == NULL)
+	{
+		return -1;
+	}
+	if(fread(&header, sizeof(BM_TraceHeader), 1, file) != 1 || memcmp(header.magic, BM_TRACE_MAGIC, sizeof(header.magic)) != 0)
+	{
+		fclose(file);
+		return -1;
+	}
+	trace->numFrames = header.numFrames;
+	trace->strategy = header.strategy;
+	trace->numRefs = 0;
+	trace->numPages = 0;
+	trace->numPins = 0;
+	trace->pages = (int *) malloc(sizeof(int) * allocated);
+	trace->dirty = (char *) malloc(allocated);
+	keys = (int *) malloc(sizeof(int) * 2 * capacity);
+	ids = (int *) malloc(sizeof(int) * capacity);
+	memset(keys, -1, sizeof(int) * 2 * capacity);
+
+	while(fread(&record, sizeof(BM_TraceRecord), 1, file) == 1)
+	{
+		micros += record.deltaMicros;
+		if(record.op == BM_TRACE_UNPIN)
+		{
+			continue;
+		}
+		//keep the hash table at most half full
+		if(2 * trace->numPages >= capacity)
+		{
+			int *oldKeys = keys, *oldIds = ids, oldCapacity = capacity, i, dummy;
+			capacity *= 2;
+			keys = (int *) malloc(sizeof(int) * 2 * capacity);
+			ids = (int *) malloc(sizeof(int) * capacity);
+			memset(keys, -1, sizeof(int) * 2 * capacity);
+			for(i = 0; i < oldCapacity; i++)
+			{
+				if(oldKeys[2 * i] != -1)
+				{
+					dummy = oldIds[i];
+					lookupPage(keys, ids, capacity, oldKeys[2 * i], oldKeys[2 * i + 1], &dummy);
+				}
+			}
+			free(oldKeys);
+			free(oldIds);
+		}
+		if(trace->numRefs == allocated)
+		{
+			allocated *= 2;
+			trace->pages = (int *) realloc(trace->pages, sizeof(int) * allocated);
+			trace->dirty = (char *) realloc(trace->dirty, allocated);
+		}
+		trace->pages[trace->numRefs] = lookupPage(keys, ids, capacity, record.fileId, record.pageNum, &trace->numPages);
+		trace->dirty[trace->numRefs] = (record.op == BM_TRACE_DIRTY);
+		if(record.op == BM_TRACE_PIN)
+		{
+			trace->numPins++;
+		}
+		trace->numRefs++;
+	}
+	trace->seconds = micros / 1000000.0;
+	free(keys);
+	free(ids);
+	fclose(file);
+	return 0;
+}
+
+/*FIFO: evicts pages in the order they were read.*/
+
+typedef struct FifoState
+{
+	int numFrames, used, hand;
+	int *frames;
+}FifoState;
+
+static void *fifoCreate(int numFrames, int numPages)
+{
+	FifoState *s = (FifoState *) calloc(1, sizeof(FifoState));
+	//FIFO keeps no per page state, numPages is only there to match the other policies
+	(void) numPages;
+	s->numFrames = numFrames;
+	s->frames = (int *) malloc(sizeof(int) * numFrames);
+	return s;
+}
+
+static int fifoAccess(void *state, int page, int hit)
+{
+	FifoState *s = state;
+	int victim;
+
+	if(hit)
+	{
+		return -1;
+	}
+	if(s->used < s->numFrames)
+	{
+		s->frames[s->used++] = page;
+		return -1;
+	}
+	victim = s->frames[s->hand];
+	s->frames[s->hand] = page;
+	s->hand = (s->hand + 1) % s->numFrames;
+	return victim;
+}
+
+static void fifoDestroy(void *state)
+{
+	free(((FifoState *) state)->frames);
+	free(state);
+}
+
+/*LRU: a doubly linked list over the pages, most recently used first.*/
+
+typedef struct LruState
+{
+	int numFrames, used, first, last;
+	int *prev, *next;
+}LruState;
+
+static void *lruCreate(int numFrames, int numPages)
+{
+	LruState *s = (LruState *) calloc(1, sizeof(LruState));
+	s->numFrames = numFrames;
+	s->first = s->last = -1;
+	s->prev = (int *) malloc(sizeof(int) * numPages);
+	s->next = (int *) malloc(sizeof(int) * numPages);
+	return s;
+}
+
+static void lruUnlink(LruState *s, int page)
+{
+	if(s->prev[page] != -1) s->next[s->prev[page]] = s->next[page]; else s->first = s->next[page];
+	if(s->next[page] != -1) s->prev[s->next[page]] = s->prev[page]; else s->last = s->prev[page];
+}
+
+static void lruPushFront(LruState *s, int page)
+{
+	s->prev[page] = -1;
+	s->next[page] = s->first;
+	if(s->first != -1) s->prev[s->first] = page; else s->last = page;
+	s->first = page;
+}
+
+static int lruAccess(void *state, int page, int hit)
+{
+	LruState *s = state;
+	int victim = -1;
+
+	if(hit)
+	{
+		lruUnlink(s, page);
+	}
+	else if(s->used < s->numFrames)
+	{
+		s->used++;
+	}
+	else
+	{
+		victim = s->last;
+		lruUnlink(s, victim);
+	}
+	lruPushFront(s, page);
+	return victim;
+}
+
+static void lruDestroy(void *state)
+{
+	free(((LruState *) state)->prev);
+	free(((LruState *) state)->next);
+	free(state);
+}
+
+/*CLOCK: second chance with one reference bit per frame.*/
+
+typedef struct ClockState
+{
+	int numFrames, used, hand;
+	int *frames;
+	char *refBits;
+	int *slotOf;
+}ClockState;
+
+static void *clockCreate(int numFrames, int numPages)
+{
+	ClockState *s = (ClockState *) calloc(1, sizeof(ClockState));
+	s->numFrames = numFrames;
+	s->frames = (int *) malloc(sizeof(int) * numFrames);
+	s->refBits = (char *) calloc(numFrames, 1);
+	s->slotOf = (int *) malloc(sizeof(int) * numPages);
+	return s;
+}
+
+static int clockAccess(void *state, int page, int hit)
+{
+	ClockState *s = state;
+	int victim;
+
+	if(hit)
+	{
+		s->refBits[s->slotOf[page]] = 1;
+		return -1;
+	}
+	if(s->used < s->numFrames)
+	{
+		s->slotOf[page] = s->used;
+		s->frames[s->used++] = page;
+		return -1;
+	}
+	while(s->refBits[s->hand])
+	{
+		s->refBits[s->hand] = 0;
+		s->hand = (s->hand + 1) % s->numFrames;
+	}
+	victim = s->frames[s->hand];
+	s->frames[s->hand] = page;
+	s->slotOf[page] = s->hand;
+	s->hand = (s->hand + 1) % s->numFrames;
+	return victim;
+}
+
+static void clockDestroy(void *state)
+{
+	ClockState *s = state;
+	free(s->frames);
+	free(s->refBits);
+	free(s->slotOf);
+	free(s);
+}
+
+/*LRU-2 and LFU: both pick the victim with a scan over the frames.
+	LRU-2 evicts the page whose second to last reference is oldest, pages referenced once first.
+	LFU evicts the page with the fewest references since it was read, the least recently used on ties.*/
+
+typedef struct ScanState
+{
+	int numFrames, used;
+	long now;
+	int *frames;
+	int *slotOf;
+	long *last, *secondLast; // reference times, kept for evicted pages too (LRU-2)
+	long *count; // references since the page was read (LFU)
+	int lfu;
+}ScanState;
+
+static void *scanCreate(int numFrames, int numPages, int lfu)
+{
+	ScanState *s = (ScanState *) calloc(1, sizeof(ScanState));
+	s->numFrames = numFrames;
+	s->lfu = lfu;
+	s->frames = (int *) malloc(sizeof(int) * numFrames);
+	s->slotOf = (int *) malloc(sizeof(int) * numPages);
+	s->last = (long *) calloc(numPages, sizeof(long));
+	s->secondLast = (long *) calloc(numPages, sizeof(long));
+	s->count = (long *) calloc(numPages, sizeof(long));
+	return s;
+}
+
+static void *lruKCreate(int numFrames, int numPages)
+{
+	return scanCreate(numFrames, numPages, 0);
+}
+
+static void *lfuCreate(int numFrames, int numPages)
+{
+	return scanCreate(numFrames, numPages, 1);
+}
+
+static int scanAccess(void *state, int page, int hit)
+{
+	ScanState *s = state;
+	int i, slot, best = 0, victim = -1;
+
+	s->now++;
+	if(!hit)
+	{
+		if(s->used < s->numFrames)
+		{
+			slot = s->used++;
+		}
+		else
+		{
+			for(i = 1; i < s->numFrames; i++)
+			{
+				int a = s->frames[i], b = s->frames[best];
+				if(s->lfu ? (s->count[a] < s->count[b] || (s->count[a] == s->count[b] && s->last[a] < s->last[b]))
+						: (s->secondLast[a] < s->secondLast[b] || (s->secondLast[a] == s->secondLast[b] && s->last[a] < s->last[b])))
+				{
+					best = i;
+				}
+			}
+			slot = best;
+			victim = s->frames[slot];
+		}
+		s->frames[slot] = page;
+		s->slotOf[page] = slot;
+		s->count[page] = 0;
+	}
+	s->count[page]++;
+	s->secondLast[page] = s->last[page];
+	s->last[page] = s->now;
+	return victim;
+}
+
+static void scanDestroy(void *state)
+{
+	ScanState *s = state;
+	free(s->frames);
+	free(s->slotOf);
+	free(s->last);
+	free(s->secondLast);
+	free(s->count);
+	free(s);
+}
+
+/*ARC: adaptive replacement cache (Megiddo and Modha). T1 and T2 hold the resident pages seen
+	once and more than once, B1 and B2 remember pages recently evicted from them.
+	The target size of T1 moves towards whichever ghost list gets hits.*/
+
+enum { ARC_NONE, ARC_T1, ARC_T2, ARC_B1, ARC_B2 };
+
+typedef struct ArcState
+{
+	int numFrames;
+	double target;
+	int first[5], last[5], size[5];
+	int *prev, *next;
+	char *list;
+}ArcState;
+
+static void *arcCreate(int numFrames, int numPages)
+{
+	ArcState *s = (ArcState *) calloc(1, sizeof(ArcState));
+	int i;
+	s->numFrames = numFrames;
+	for(i = 0; i < 5; i++)
+	{
+		s->first[i] = s->last[i] = -1;
+	}
+	s->prev = (int *) malloc(sizeof(int) * numPages);
+	s->next = (int *) malloc(sizeof(int) * numPages);
+	s->list = (char *) calloc(numPages, 1);
+	return s;
+}
+
+static void arcMove(ArcState *s, int page, int to)
+{
+	int from = s->list[page];
+
+	if(from != ARC_NONE)
+	{
+		if(s->prev[page] != -1) s->next[s->prev[page]] = s->next[page]; else s->first[from] = s->next[page];
+		if(s->next[page] != -1) s->prev[s->next[page]] = s->prev[page]; else s->last[from] = s->prev[page];
+		s->size[from]--;
+	}
+	s->list[page] = to;
+	if(to != ARC_NONE)
+	{
+		s->prev[page] = -1;
+		s->next[page] = s->first[to];
+		if(s->first[to] != -1) s->prev[s->first[to]] = page; else s->last[to] = page;
+		s->first[to] = page;
+		s->size[to]++;
+	}
+}
+
+static int arcReplace(ArcState *s, int inB2)
+{
+	int victim;
+
+	if(s->size[ARC_T1] + s->size[ARC_T2] < s->numFrames)
+	{
+		return -1;
+	}
+	if(s->size[ARC_T1] > 0 && ((inB2 && s->size[ARC_T1] == (int) s->target) || s->size[ARC_T1] > s->target))
+	{
+		victim = s->last[ARC_T1];
+		arcMove(s, victim, ARC_B1);
+	}
+	else
+	{
+		victim = s->last[ARC_T2];
+		arcMove(s, victim, ARC_B2);
+	}
+	return victim;
+}
+
+static int arcAccess(void *state, int page, int hit)
+{
+	ArcState *s = state;
+	int victim = -1, total;
+	double delta;
+
+	if(hit)
+	{
+		arcMove(s, page, ARC_T2);
+		return -1;
+	}
+	if(s->list[page] == ARC_B1)
+	{
+		delta = (s->size[ARC_B2] > s->size[ARC_B1]) ? (double) s->size[ARC_B2] / s->size[ARC_B1] : 1;
+		s->target = (s->target + delta > s->numFrames) ? s->numFrames : s->target + delta;
+		victim = arcReplace(s, 0);
+		arcMove(s, page, ARC_T2);
+		return victim;
+	}
+	if(s->list[page] == ARC_B2)
+	{
+		delta = (s->size[ARC_B1] > s->size[ARC_B2]) ? (double) s->size[ARC_B1] / s->size[ARC_B2] : 1;
+		s->target = (s->target - delta < 0) ? 0 : s->target - delta;
+		victim = arcReplace(s, 1);
+		arcMove(s, page, ARC_T2);
+		return victim;
+	}
+	if(s->size[ARC_T1] + s->size[ARC_B1] == s->numFrames)
+	{
+		if(s->size[ARC_T1] < s->numFrames)
+		{
+			arcMove(s, s->last[ARC_B1], ARC_NONE);
+			victim = arcReplace(s, 0);
+		}
+		else
+		{
+			victim = s->last[ARC_T1];
+			arcMove(s, victim, ARC_NONE);
+		}
+	}
+	else
+	{
+		total = s->size[ARC_T1] + s->size[ARC_T2] + s->size[ARC_B1] + s->size[ARC_B2];
+		if(total >= s->numFrames)
+		{
+			if(total == 2 * s->numFrames)
+			{
+				arcMove(s, s->last[ARC_B2], ARC_NONE);
+			}
+			victim = arcReplace(s, 0);
+		}
+	}
+	arcMove(s, page, ARC_T1);
+	return victim;
+}
+
+static void arcDestroy(void *state)
+{
+	ArcState *s = state;
+	free(s->prev);
+	free(s->next);
+	free(s->list);
+	free(s);
+}
+
+static const SimPolicy policies[] = {
+	{"FIFO", fifoCreate, fifoAccess, fifoDestroy},
+	{"LRU", lruCreate, lruAccess, lruDestroy},
+	{"CLOCK", clockCreate, clockAccess, clockDestroy},
+	{"LRU-2", lruKCreate, scanAccess, scanDestroy},
+	{"LFU", lfuCreate, scanAccess, scanDestroy},
+	{"ARC", arcCreate, arcAccess, arcDestroy}
+};
+#define NUM_POLICIES ((int) (sizeof(policies) / sizeof(policies[0])))
+
+/*
+ * Function: simulate
+ * ---------------------------
+ * Replays a trace against one policy and pool size. A page marked dirty is written back
+ * when it is evicted, a page marked dirty after it was evicted is written back at once.
+ *
+ * trace: The trace.
+ * policy: The replacement policy.
+ * numFrames: Simulated pool size.
+ * hits: Receives the number of pins served from the pool.
+ * writes: Receives the number of write-backs.
+ *
+ * return: void
+ *
+ */
+
+static void simulate(const SimTrace *trace, const SimPolicy *policy, int numFrames, long *hits, long *writes)
+{
+	char *resident = (char *) calloc(trace->numPages, 1);
+	char *dirty = (char *) calloc(trace->numPages, 1);
+	void *state = policy->create(numFrames, trace->numPages);
+	int i, page, victim;
+
+	*hits = 0;
+	*writes = 0;
+	for(i = 0; i < trace->numRefs; i++)
+	{
+		page = trace->pages[i];
+		if(trace->dirty[i])
+		{
+			if(resident[page])
+			{
+				dirty[page] = 1;
+			}
+			else
+			{
+				(*writes)++;
+			}
+			continue;
+		}
+		if(resident[page])
+		{
+			(*hits)++;
+		}
+		victim = policy->access(state, page, resident[page]);
+		resident[page] = 1;
+		if(victim >= 0)
+		{
+			resident[victim] = 0;
+			if(dirty[victim])
+			{
+				dirty[victim] = 0;
+				(*writes)++;
+			}
+		}
+	}
+	policy->destroy(state);
+	free(resident);
+	free(dirty);
+}
+
+int main(int argc, char *argv[])
+{
+	SimTrace trace;
+	int *sizes, numSizes = 0, i, p;
+	long *hits, *writes;
+
+	if(argc < 2)
+	{
+		fprintf(stderr, "usage: %s traceFile [numFrames ...]\n", argv[0]);
+		return 1;
+	}
+	if(loadTrace(argv[1], &trace) != 0)
+	{
+		fprintf(stderr, "%s: not a buffer pool trace\n", argv[1]);
+		return 1;
+	}
+	if(trace.numPins == 0)
+	{
+		printf("%s: no pins recorded\n", argv[1]);
+		return 0;
+	}
+
+	sizes = (int *) malloc(sizeof(int) * (argc > DEFAULT_MAX_SIZES ? argc : DEFAULT_MAX_SIZES));
+	for(i = 2; i < argc; i++)
+	{
+		if(atoi(argv[i]) > 0)
+		{
+			sizes[numSizes++] = atoi(argv[i]);
+		}
+	}
+	if(numSizes == 0)
+	{
+		for(i = 1; i < trace.numPages && numSizes < DEFAULT_MAX_SIZES - 1; i *= 2)
+		{
+			sizes[numSizes++] = i;
+		}
+		sizes[numSizes++] = trace.numPages;
+	}
+	hits = (long *) malloc(sizeof(long) * numSizes * NUM_POLICIES);
+	writes = (long *) malloc(sizeof(long) * numSizes * NUM_POLICIES);
+	for(i = 0; i < numSizes; i++)
+	{
+		for(p = 0; p < NUM_POLICIES; p++)
+		{
+			simulate(&trace, &policies[p], sizes[i], &hits[i * NUM_POLICIES + p], &writes[i * NUM_POLICIES + p]);
+		}
+	}
+
+	printf("trace %s: %d pins, %d pages, %.3f s, traced pool %d frames\n",
+			argv[1], trace.numPins, trace.numPages, trace.seconds, trace.numFrames);
+	printf("\nhit ratio (%%)\n%8s", "frames");
+	for(p = 0; p < NUM_POLICIES; p++)
+	{
+		printf("%9s", policies[p].name);
+	}
+	for(i = 0; i < numSizes; i++)
+	{
+		printf("\n%8d", sizes[i]);
+		for(p = 0; p < NUM_POLICIES; p++)
+		{
+			printf("%9.2f", 100.0 * hits[i * NUM_POLICIES + p] / trace.numPins);
+		}
+	}
+	printf("\n\nwrite-backs\n%8s", "frames");
+	for(p = 0; p < NUM_POLICIES; p++)
+	{
+		printf("%9s", policies[p].name);
+	}
+	for(i = 0; i < numSizes; i++)
+	{
+		printf("\n%8d", sizes[i]);
+		for(p = 0; p < NUM_POLICIES; p++)
+		{
+			printf("%9ld", writes[i * NUM_POLICIES + p]);
+		}
+	}
+	printf("\n");
+
+	free(hits);
+	free(writes);
+	free(sizes);
+	free(trace.pages);
+	free(trace.dirty);
+	return 0;
+}
@@ -31,6 +31,19 @@ typedef int RC;
 #define RC_TABLE_ALREADY_EXISTS 400
 #define RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD 401
 #define RC_RM_NO_DESERIALIZER_FOR_THIS_DATATYPE 402
+#define RC_RM_RECORD_TOO_LARGE 403
+#define RC_RM_BAD_TABLE_HEADER 404
+#define RC_RM_INVALID_LOAD_OPTIONS 405
+#define RC_RM_FILTER_NOT_SUPPORTED 406
+
+#define RC_BM_WRITER_ALREADY_RUNNING 500
+#define RC_BM_INVALID_WRITER_CONFIG 501
+#define RC_BM_GLOBAL_POOL_NOT_INIT 502
+#define RC_BM_INVALID_POOL_SIZE 503
+#define RC_BM_FRAMES_PINNED 504
+#define RC_BM_UNKNOWN_STRATEGY 505
+#define RC_BM_PIN_TIMEOUT 506
+#define RC_BM_TRACE_ALREADY_RUNNING 507
 
 /* holder for error messages */
 extern char *RC_message;
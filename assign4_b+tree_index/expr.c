@@ -50,6 +50,7 @@ valueSmaller (Value *left, Value *right, Value *result)
 		break;
 	case DT_BOOL:
 		result->v.boolV = (left->v.boolV < right->v.boolV);
+		break;
 	case DT_STRING:
 		result->v.boolV = (strcmp(left->v.stringV, right->v.stringV) < 0);
 		break;
@@ -74,6 +75,7 @@ boolAnd (Value *left, Value *right, Value *result)
 {
 	if (left->dt != DT_BOOL || right->dt != DT_BOOL)
 		THROW(RC_RM_BOOLEAN_EXPR_ARG_IS_NOT_BOOLEAN, "boolean AND requires boolean inputs");
+	result->dt = DT_BOOL;
 	result->v.boolV = (left->v.boolV && right->v.boolV);
 
 	return RC_OK;
@@ -84,6 +86,7 @@ boolOr (Value *left, Value *right, Value *result)
 {
 	if (left->dt != DT_BOOL || right->dt != DT_BOOL)
 		THROW(RC_RM_BOOLEAN_EXPR_ARG_IS_NOT_BOOLEAN, "boolean OR requires boolean inputs");
+	result->dt = DT_BOOL;
 	result->v.boolV = (left->v.boolV || right->v.boolV);
 
 	return RC_OK;
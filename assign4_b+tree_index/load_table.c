@@ -0,0 +1,133 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "record_mgr.h"
+#include "table_loader.h"
+
+/*Table loader utility.
+	Appends the rows of a file to an existing table with loadTable and prints the load rate.
+
+	usage: load_table tableFile dataFile [-d delimiter] [-w width,width,...] [-b] [-H] [-t threads] [-c chunkKB]
+	-d  rows are delimited by the given character, ',' by default
+	-w  rows are fixed width with the given field widths
+	-b  rows are in the binary Record.data layout
+	-H  skip the header line
+	-t  number of converting threads, one per processor by default
+	-c  kilobytes of input converted at a time*/
+
+/*
+ * Function: parseWidths
+ * ---------------------------
+ * Parses a comma separated list of field widths.
+ *
+ * list: The list.
+ * numAttr: Number of attributes of the table.
+ *
+ * return: the widths, NULL if the list does not have numAttr positive widths.
+ *
+ */
+
+static int *parseWidths(char *list, int numAttr)
+{
+	int *widths = (int *) malloc(numAttr * sizeof(int));
+	char *end = list;
+	int i;
+
+	for(i = 0; i < numAttr; i++)
+	{
+		widths[i] = strtol(end, &end, 10);
+		if(widths[i] <= 0 || (i < numAttr - 1 && *end++ != ','))
+		{
+			free(widths);
+			return NULL;
+		}
+	}
+	if(*end != '\0')
+	{
+		free(widths);
+		return NULL;
+	}
+	return widths;
+}
+
+int main(int argc, char *argv[])
+{
+	RM_TableData table;
+	RM_LoadOptions options;
+	RM_LoadStats stats;
+	char *widthList = NULL;
+	int i;
+	RC rc;
+
+	if(argc < 3)
+	{
+		fprintf(stderr, "usage: %s tableFile dataFile [-d delimiter] [-w width,width,...] [-b] [-H] [-t threads] [-c chunkKB]\n", argv[0]);
+		return 1;
+	}
+	initLoadOptions(&options);
+	for(i = 3; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+		{
+			options.format = RM_LOAD_DELIMITED;
+			options.delimiter = (strcmp(argv[i + 1], "\\t") == 0) ? '\t' : argv[i + 1][0];
+			i++;
+		}
+		else if(strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+		{
+			options.format = RM_LOAD_FIXED_WIDTH;
+			widthList = argv[++i];
+		}
+		else if(strcmp(argv[i], "-b") == 0)
+		{
+			options.format = RM_LOAD_BINARY;
+		}
+		else if(strcmp(argv[i], "-H") == 0)
+		{
+			options.skipHeader = TRUE;
+		}
+		else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			options.numWorkers = atoi(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+		{
+			options.chunkSize = atoi(argv[++i]) * 1024;
+		}
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	initRecordManager(NULL);
+	rc = openTable(&table, argv[1]);
+	if(rc != RC_OK)
+	{
+		fprintf(stderr, "cannot open table %s: %d\n", argv[1], rc);
+		return 1;
+	}
+	if(widthList != NULL)
+	{
+		options.fieldWidths = parseWidths(widthList, table.schema->numAttr);
+		if(options.fieldWidths == NULL)
+		{
+			fprintf(stderr, "need %d field widths\n", table.schema->numAttr);
+			closeTable(&table);
+			return 1;
+		}
+	}
+
+	rc = loadTable(&table, argv[2], &options, &stats);
+	printf("rows %ld rejected %ld pages %ld\n", stats.rows, stats.rejectedRows, stats.pages);
+	printf("%.3f s, %.0f rows/s, %d tuples in table\n", stats.seconds, stats.rowsPerSecond, getNumTuples(&table));
+	if(rc != RC_OK)
+	{
+		fprintf(stderr, "load failed: %d\n", rc);
+	}
+	free(options.fieldWidths);
+	closeTable(&table);
+	shutdownRecordManager();
+	return rc != RC_OK;
+}
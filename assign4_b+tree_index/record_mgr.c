@@ -6,44 +6,127 @@
 #include "storage_mgr.h"
 #include "record_mgr.h"
 #include "expr.h"
+#include "batch_filter.h"
 
 
-int totalPages;
-//Management structure for maintaining RECORD MANGER metadata.
-typedef struct Record_Manager
-{
-	int *freePages;
-	BM_BufferPool *bm;
-}
-Record_Manager;
+//Number of heap pages a scan asks the buffer pool to read ahead of its position.
+#define SCAN_PREFETCH_DEPTH 4
+//Frames a scan recycles for the pages it reads, larger than SCAN_PREFETCH_DEPTH so read-ahead pages are consumed before their frame is reused.
+#define SCAN_RING_SIZE 8
+//Frames recycled by a run of insertRecord calls on one table.
+#define INSERT_RING_SIZE 4
+//Pages a bulk load builds in memory before appending them to the file with one write.
+#define BULK_EXTENT_PAGES 64
+//Tag at the start of page 0 of a table file.
+#define RM_TABLE_MAGIC "RMT1"
 
 //Management structure for maintaining TABLE metadata.
+//Stored in binary at the start of page 0, followed by the serialized schema of schemaSize bytes.
 typedef struct RecordMgr_Table
 {
-
-	int schemaSize;
+	char magic[4];
 	int numOfTuples;
+	int numPages; // pages of the file, page 0 included
+	int fsmRoot; // first free-space map page
+	int schemaSize;
+	RM_TableStats stats;
+	int needsRecovery; // set while the pages may be ahead of the header: the table is open with RM_WRITE_BACK or modified since it was opened, see recoverTable
 }
 RecordMgr_Table;
 
+//Operations of the redo log of a table in RM_WRITE_BACK mode
+#define LOG_SET_TUPLE 1 // slot holds the tuple behind the record, after an insert or update
+#define LOG_FREE_SLOT 2 // slot was freed by a delete
+
+//Record of the redo log, followed by length bytes of the tuple for LOG_SET_TUPLE
+typedef struct RM_LogRecord
+{
+	int op;
+	int page;
+	int slot;
+	int length;
+}
+RM_LogRecord;
+
+//Management structure for maintaining RECORD MANGER metadata.
+typedef struct Record_Manager
+{
+	int *freePages;
+	BM_BufferPool *bm;
+	BM_AccessStrategy insertRing;
+	RecordMgr_Table table; // copy of the table header, written back by writeTableHeader
+	RM_WritePolicy writePolicy;
+	FILE *log; // redo log, open in RM_WRITE_BACK mode
+	char *logName;
+}
+Record_Manager;
+
 
 //Management structure for maintaining RECORD SCAN MANGER metadata.
 typedef struct RecordMgr_ScanMgmt
 {
-	Record *currentRecord;
 	int currentPage;
 	int currentSlot;
+	int prefetchedUpTo;
+	BM_AccessStrategy ring;
 	Expr *condn;
+	BM_PageHandle heldPage; // page under the cursor, pinned once for all of its slots
+	int holding; // 1 while heldPage is pinned
+	bool columnFilter; // nextBatch evaluates condn on the columns of a batch, see canFilterBatch
 }
 RecordMgr_ScanMgmt;
 
+//Management structure for maintaining BULK LOAD metadata.
+typedef struct RecordMgr_BulkMgmt
+{
+	char *extent; // BULK_EXTENT_PAGES pages built in memory
+	int firstPage; // page number of the first extent page
+	int usedPages; // extent pages in use, the last one is being filled
+	int numTuples; // tuples on the extent pages
+	int heapPages; // extent pages which are heap pages, not map pages
+}
+RecordMgr_BulkMgmt;
+
+/*Layout of a heap page (pages 1 and up): an RM_PageHeader, the slot directory growing upwards
+	behind it, and the tuples packed from the end of the page downwards. RID.slot indexes the directory.
+	A tuple is the binary Record.data of getRecordSize bytes, serializeRecord gives its text form for debugging.
+	A slot with length 0 is free, deleting a record frees its slot, the bytes are reclaimed by compactPage.*/
+
+typedef struct RM_PageHeader
+{
+	int numSlots;
+	int freeEnd; // offset of the lowest tuple byte, PAGE_SIZE on an empty page
+}
+RM_PageHeader;
+
+typedef struct RM_Slot
+{
+	unsigned short offset;
+	unsigned short length;
+}
+RM_Slot;
+
+#define PAGE_HEADER(data) ((RM_PageHeader *) (data))
+#define PAGE_SLOTS(data) ((RM_Slot *) ((data) + sizeof(RM_PageHeader)))
+
+/*Free-space map: one 4 bit category per page, the free bytes of the page divided by FSM_UNIT.
+	The map page for pages [k*FSM_ENTRIES, (k+1)*FSM_ENTRIES) is page k*FSM_ENTRIES, the first one is page 1.
+	A map page has the header of a heap page with no slots and freeEnd 0, so scans pass over it.*/
+
+#define FSM_ENTRIES ((int) (PAGE_SIZE - sizeof(RM_PageHeader)) * 2)
+#define FSM_UNIT (PAGE_SIZE / 16)
+#define FSM_MAP(data) ((unsigned char *) ((data) + sizeof(RM_PageHeader)))
+
+static RC fetchRecord (RM_TableData *rel, RID id, Record *record, BM_AccessStrategy *ring);
+static RC pinSlot (RM_TableData *rel, RID id, BM_AccessStrategy *ring, BM_PageHandle *page, char **tuple);
+
 
 
 /*
  * Function: updatePageInfo
  * ---------------------------
  * This method is used to update the page information by calling
- * makeDirty, unpinPage and forcePage functions in buffer manager.
+ * makeDirty, unpinPage and, with RM_WRITE_FORCE, forcePage functions in buffer manager.
  *
  * schema : Management structure to maintain schema details.
  * result : Used to store the offset.
@@ -56,468 +139,1993 @@ RecordMgr_ScanMgmt;
 void updatePageInfo(RM_TableData *rel, BM_PageHandle *page){
 	markDirty(((Record_Manager *)rel->mgmtData)->bm, page);
 	unpinPage(((Record_Manager *)rel->mgmtData)->bm, page);
-	forcePage(((Record_Manager *)rel->mgmtData)->bm, page);
+	//in write-back mode the redo log makes the change durable, the page is written by eviction or checkpoint
+	if(((Record_Manager *)rel->mgmtData)->writePolicy == RM_WRITE_FORCE)
+	{
+		forcePage(((Record_Manager *)rel->mgmtData)->bm, page);
+	}
 }
 
 /*
- * Function: attrituteOffset
+ * Function: writeTableHeader
  * ---------------------------
- * This method calculates the offset associated with each attribute
- * by taking size of each attribute datatype.
+ * This method copies the table header into page 0 and marks it dirty. Page 0 stays resident,
+ * it is written when the pool flushes it or the table is closed.
  *
- * schema : Management structure to maintain schema details.
- * result : Used to store the offset.
- * attrNum : Number of attributes.
+ * rel: Management Structure for a Record Manager to handle one relation.
  *
- * returns : RC_OK if all steps in attributeOffSet are successful.
+ * returns : RC_OK if the header was copied.
+ *			 pinPage errors if page 0 cannot be pinned.
  *
  */
 
-RC attrituteOffset (Schema *schema, int attrNum, int *result)
+static RC writeTableHeader(RM_TableData *rel)
 {
-	int offset = 0;
-	int attrPosition = 0;
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	BM_PageHandle page;
+	RC flag;
 
-	while(attrPosition < attrNum)
+	flag = pinPageWithPriority(rm_mgmt->bm, &page, 0, BM_PRIORITY_HOT);
+	if(flag != RC_OK)
 	{
-		switch (schema->dataTypes[attrPosition])
-		{
-		case DT_STRING:
-			offset += schema->typeLength[attrPosition];
-			break;
-		case DT_INT:
-			offset += sizeof(int);
-			break;
-		case DT_FLOAT:
-			offset += sizeof(float);
-			break;
-		case DT_BOOL:
-			offset += sizeof(bool);
-			break;
-		}
-		attrPosition+=1;
+		return flag;
 	}
-
-	*result = offset;
+	memcpy(page.data, &rm_mgmt->table, sizeof(RecordMgr_Table));
+	markDirty(rm_mgmt->bm, &page);
+	unpinPage(rm_mgmt->bm, &page);
 	return RC_OK;
 }
 
 /*
- * Function: initRecordManager
+ * Function: forceTableHeader
  * ---------------------------
- * This method initializes the record manager.
+ * This method writes the table header to disk at once, for flags recovery depends on.
  *
- * returns : RC_OK as initialing is done and nothing is left to initialize.
+ * rel: Management Structure for a Record Manager to handle one relation.
+ *
+ * returns : RC_OK if the header was written.
+ *			 pinPage or forcePage errors if it cannot be written.
  *
  */
 
-RC initRecordManager (void *mgmtData)
+static RC forceTableHeader(RM_TableData *rel)
 {
-	printf("Initializing record manager done!\n");
-	return RC_OK;
+	BM_PageHandle page;
+	RC flag = writeTableHeader(rel);
+
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	page.pageNum = 0;
+	return forcePage(((Record_Manager *)rel->mgmtData)->bm, &page);
 }
 
 /*
- * Function: shutdownRecordManager
+ * Function: markTableModified
  * ---------------------------
- * This method shuts down the record manager.
+ * This method is called before a modification changes the tuple count or the pages of a table.
+ * The header with these counts is only written on close and checkpoints, so the first modification
+ * after opening forces a header asking openTable to recount them if the table is not closed.
  *
- * returns : RC_OK as memory is made free during allocation.
+ * rel: Management Structure for a Record Manager to handle one relation.
+ *
+ * returns : RC_OK if the header on disk asks for recovery.
+ *			 forceTableHeader errors if it cannot be written, the table is not modified then.
  *
  */
-RC shutdownRecordManager ()
+
+static RC markTableModified(RM_TableData *rel)
 {
-	printf("Shutdown of record manager done!\n");
-	return RC_OK;
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	RC flag;
+
+	if(rm_mgmt->table.needsRecovery)
+	{
+		return RC_OK;
+	}
+	rm_mgmt->table.needsRecovery = 1;
+	flag = forceTableHeader(rel);
+	if(flag != RC_OK)
+	{
+		rm_mgmt->table.needsRecovery = 0;
+	}
+	return flag;
 }
 
 /*
- * Function: createTable
+ * Function: logOperation
  * ---------------------------
- * This function is used to Create a Table.
- * Create the underlying page file and store information about the schema, free-space, ...
- * and so on in the Table Information pages.
+ * This method appends a redo record to the log of a table in RM_WRITE_BACK mode and hands it
+ * to the operating system. It is called before the modified page is unpinned, so the pool never
+ * writes a page whose change is not in the log.
  *
- * name: Name of the relation/table.
- * schema: Schema of the table.
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * op: LOG_SET_TUPLE or LOG_FREE_SLOT.
+ * id: The slot.
+ * tuple: The tuple for LOG_SET_TUPLE.
+ * len: Length of the tuple.
  *
- * returns : RC_FILE_NOT_FOUND if pagefile creation of opening fails.
- *					 RC_WRITE_FAILED if write operation for writing serialized data fails.
- * 					 RC_OK if all steps are executed and table is created.
+ * returns : void
  *
  */
-RC createTable (char *name, Schema *schema)
-{
-	SM_FileHandle filehandle;
- 	char *serializedData = serializeSchema(schema);
-	int i;
-	for(i=0;i<sizeof(serializedData); i++){
-		printf("%c ",serializedData[i]);
-	}
 
- 	RecordMgr_Table *tableInfo = (RecordMgr_Table *)malloc(sizeof(RecordMgr_Table));
-
- 	RC createPageFlag = createPageFile(name);
- 	RC openPageFlag = openPageFile(name,&filehandle);
- 	if(createPageFlag!=RC_OK || openPageFlag!=RC_OK)
- 	{
- 		return RC_FILE_NOT_FOUND;
- 	}
+static void logOperation(RM_TableData *rel, int op, RID id, char *tuple, int len)
+{
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	RM_LogRecord logRecord;
 
- 	tableInfo->schemaSize = 0;
- 	RC writeflag = writeBlock(0,&filehandle,serializedData);
- 	if(writeflag!=RC_OK)
- 	{
- 		return RC_WRITE_FAILED;
- 	}
-	return RC_OK;
+	if(rm_mgmt->writePolicy != RM_WRITE_BACK || rm_mgmt->log == NULL)
+	{
+		return;
+	}
+	logRecord.op = op;
+	logRecord.page = id.page;
+	logRecord.slot = id.slot;
+	logRecord.length = (op == LOG_SET_TUPLE) ? len : 0;
+	fwrite(&logRecord, sizeof(RM_LogRecord), 1, rm_mgmt->log);
+	if(op == LOG_SET_TUPLE)
+	{
+		fwrite(tuple, 1, len, rm_mgmt->log);
+	}
+	fflush(rm_mgmt->log);
 }
 
 /*
-* Function: openTable
-* ---------------------------
-* This function is used to Open a table which is already created with name. This should have a pageFile created.
-* For any operation to be performed, the table has to be opened first.
-*
-* name: Name of the relation/table.
-* rel: Management Structure for a Record Manager to handle one relation.
-*
-* returns : RC_OK if all steps are executed and table is opened.
-*/
-RC openTable (RM_TableData *rel, char *name)
-{
-	Record_Manager *rm_mgmt = (Record_Manager*)malloc(sizeof(Record_Manager));
-	FILE *fptr = fopen(name, "r+");	char* readHeader;
-	readHeader = (char*)calloc(PAGE_SIZE,sizeof(char));
-	fgets(readHeader,PAGE_SIZE,fptr);
-	char* totalPage = readHeader;
-	totalPages = atoi(totalPage);
-	rm_mgmt->bm = MAKE_POOL();
+ * Function: initHeapPage
+ * ---------------------------
+ * This method formats an empty heap page.
+ *
+ * data : Page data.
+ *
+ * returns : void
+ *
+ */
 
-	//Make a Page Handle
-	BM_PageHandle *page = MAKE_PAGE_HANDLE();
-	initBufferPool(rm_mgmt->bm,name,6,RS_FIFO,NULL);
-	pinPage(rm_mgmt->bm,page,0);
-	rm_mgmt->freePages = (int*)malloc(sizeof(int));
-	rm_mgmt->freePages[0] = totalPages;
-	rel->schema = deserializeSchema(page->data);
-	rel->name = name;
-	rel->mgmtData = rm_mgmt;
-	free(readHeader);
-	free(page);
-	return RC_OK;
+static void initHeapPage(char *data)
+{
+	memset(data, 0, PAGE_SIZE);
+	PAGE_HEADER(data)->numSlots = 0;
+	PAGE_HEADER(data)->freeEnd = PAGE_SIZE;
 }
 
 /*
-* Function: closeTable
-* ---------------------------
-* The table is closed after all the operations are completed.
-* All the memory allocations are de-allocated to avoid memory leaks.
-*
-* rel: Management Structure for a Record Manager to handle one relation.
-*
-* returns : RC_OK after all memory allocations are de-allocated and table is closed.
-*/
-RC closeTable (RM_TableData *rel)
-{
-	printf(" Entered close Table \n");
-	Record_Manager *rmgmt = (Record_Manager*)malloc(sizeof(Record_Manager));
-	rmgmt = rel->mgmtData;
-	shutdownBufferPool(rmgmt->bm);
-	free(rmgmt);
-	free(rel->schema->attrNames);
-	free(rel->schema->dataTypes);
-	free(rel->schema->keyAttrs);
-	free(rel->schema->typeLength);
+ * Function: compactPage
+ * ---------------------------
+ * This method moves the tuples of a heap page together at the end of the page,
+ * reclaiming the space of deleted and shrunk tuples. Slot numbers do not change.
+ *
+ * data : Page data.
+ *
+ * returns : void
+ *
+ */
 
-	free(rel->schema);
+static void compactPage(char *data)
+{
+	char copy[PAGE_SIZE];
+	RM_Slot *slots = PAGE_SLOTS(data);
+	int i, freeEnd = PAGE_SIZE;
 
-	return RC_OK;
+	memcpy(copy, data, PAGE_SIZE);
+	for(i = 0; i < PAGE_HEADER(data)->numSlots; i++)
+	{
+		if(slots[i].length != 0)
+		{
+			freeEnd -= slots[i].length;
+			memcpy(data + freeEnd, copy + slots[i].offset, slots[i].length);
+			slots[i].offset = freeEnd;
+		}
+	}
+	PAGE_HEADER(data)->freeEnd = freeEnd;
 }
 
 /*
-* Function: deleteTable
-* ---------------------------
-* This function deletes the table using destroyPageFile function from buffermanager.
-*
-* name: Name of the relation/table.
-*
-* returns : RC_OK if destroy pagefile is successful.
-*					RC_FILE_NOT_FOUND if file is pagefile is not found.
-*/
+ * Function: nextFreeSlot
+ * ---------------------------
+ * This method returns the slot the next tuple stored on a heap page gets:
+ * the first free slot, or a new one at the end of the directory.
+ *
+ * data : Page data.
+ *
+ * returns : the slot number.
+ *
+ */
 
-RC deleteTable (char *name)
+static int nextFreeSlot(char *data)
 {
-	printf("Entered Delete ");
-	RC destroyFlag = destroyPageFile(name);
-	if(destroyFlag == RC_OK)
+	RM_Slot *slots = PAGE_SLOTS(data);
+	int i;
+
+	for(i = 0; i < PAGE_HEADER(data)->numSlots; i++)
 	{
-		return RC_OK;
-	}
-	else{
-		return RC_FILE_NOT_FOUND;
+		if(slots[i].length == 0)
+		{
+			return i;
+		}
 	}
+	return PAGE_HEADER(data)->numSlots;
 }
 
 /*
-* Function: getNumTuples
-* ---------------------------
-* This function is used to get number of tuples/rows in the table.
-*
-* rel: Management Structure for a Record Manager to handle one relation.
-*
-* returns : RC_OK if destroy getRecord is successful.
-*/
+ * Function: storeTuple
+ * ---------------------------
+ * This method stores a tuple in a slot of a heap page, compacting the page if the free space
+ * is fragmented. The slot must be free or a new slot directly behind the directory.
+ *
+ * data : Page data.
+ * slot : Slot number, e.g. from nextFreeSlot.
+ * tuple : The tuple.
+ * len : Length of the tuple in bytes.
+ *
+ * returns : RC_OK if the tuple was stored.
+ *			 RC_RM_RECORD_TOO_LARGE if the page has not enough free space.
+ *
+ */
 
-int getNumTuples (RM_TableData *rel)
+static RC storeTuple(char *data, int slot, const char *tuple, int len)
 {
-	Record *record = (Record *)malloc(sizeof(Record));
-	RID rid;
-	int count = 0;
-	RC flagGetRecord;
+	RM_PageHeader *header = PAGE_HEADER(data);
+	RM_Slot *slots = PAGE_SLOTS(data);
+	int numSlots = (slot == header->numSlots) ? header->numSlots + 1 : header->numSlots;
+	int dirEnd = sizeof(RM_PageHeader) + numSlots * sizeof(RM_Slot);
+	int used = 0, i;
 
-	rid.page = 1;
-	rid.slot = 0;
-
-	while(rid.page > 0 && rid.page < totalPages)
+	if(header->freeEnd - dirEnd < len)
 	{
-		flagGetRecord = getRecord (rel, rid, record);
-		if(flagGetRecord != RC_OK)
+		for(i = 0; i < header->numSlots; i++)
 		{
-			printf("Get records failed!");
+			used += slots[i].length;
 		}
-		else{
-			count += 1;
-			rid.page += 1;
-			rid.slot = 0;
+		if(PAGE_SIZE - dirEnd - used < len)
+		{
+			return RC_RM_RECORD_TOO_LARGE;
 		}
+		compactPage(data);
 	}
+	header->numSlots = numSlots;
+	header->freeEnd -= len;
+	memcpy(data + header->freeEnd, tuple, len);
+	slots[slot].offset = header->freeEnd;
+	slots[slot].length = len;
+	return RC_OK;
+}
+
+/*
+ * Function: fsmPageOf
+ * ---------------------------
+ * This method returns the free-space map page holding the entry of a page.
+ *
+ * pageNum : The page.
+ *
+ * returns : the map page.
+ *
+ */
 
-	record = NULL;
-	free(record);
-	return count;
+static int fsmPageOf(int pageNum)
+{
+	int k = pageNum / FSM_ENTRIES;
+	return (k == 0) ? 1 : k * FSM_ENTRIES;
 }
 
 /*
- * Function: insertRecord
+ * Function: freeSpaceCategory
  * ---------------------------
- * This function is used to insert a new record into the table.
- * When a new record is inserted the record manager should assign an
- * RID to this record and update the record parameter passed to insertRecord .
+ * This method returns the free-space map category of a heap page: the bytes a new tuple
+ * and its slot can use after compaction, divided by FSM_UNIT.
+ *
+ * data : Page data.
+ *
+ * returns : the category, 0 to 15.
+ *
+ */
+
+static int freeSpaceCategory(char *data)
+{
+	RM_Slot *slots = PAGE_SLOTS(data);
+	int i, free;
+
+	free = PAGE_SIZE - sizeof(RM_PageHeader) - (PAGE_HEADER(data)->numSlots + 1) * sizeof(RM_Slot);
+	for(i = 0; i < PAGE_HEADER(data)->numSlots; i++)
+	{
+		free -= slots[i].length;
+	}
+	if(free < 0)
+	{
+		return 0;
+	}
+	return (free / FSM_UNIT > 15) ? 15 : free / FSM_UNIT;
+}
+
+/*
+ * Function: setMapEntry
+ * ---------------------------
+ * This method stores the category of a page in its free-space map page.
+ *
+ * mapData : Data of the map page, fsmPageOf(pageNum).
+ * pageNum : The page.
+ * category : Its category.
+ *
+ * returns : void
+ *
+ */
+
+static void setMapEntry(char *mapData, int pageNum, int category)
+{
+	int index = pageNum % FSM_ENTRIES;
+	unsigned char *entry = &FSM_MAP(mapData)[index / 2];
+
+	if(index % 2 == 0)
+	{
+		*entry = (*entry & 0xf0) | category;
+	}
+	else
+	{
+		*entry = (*entry & 0x0f) | (category << 4);
+	}
+}
+
+/*
+ * Function: setFreeSpace
+ * ---------------------------
+ * This method stores the category of a page in the free-space map.
+ *
+ * rel : Management Structure for a Record Manager to handle one relation.
+ * pageNum : The page.
+ * category : Its category.
+ *
+ * returns : RC_OK if the map was updated.
+ *			 pinPage errors if the map page cannot be pinned.
+ *
+ */
+
+static RC setFreeSpace(RM_TableData *rel, int pageNum, int category)
+{
+	BM_PageHandle page;
+	RC flag;
+
+	flag = pinPageWithPriority(((Record_Manager *)rel->mgmtData)->bm, &page, fsmPageOf(pageNum), BM_PRIORITY_HOT);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	setMapEntry(page.data, pageNum, category);
+	updatePageInfo(rel, &page);
+	return RC_OK;
+}
+
+/*
+ * Function: findPageWithRoom
+ * ---------------------------
+ * This method searches the free-space map for a heap page of at least a given category.
+ *
+ * rel : Management Structure for a Record Manager to handle one relation.
+ * category : Category the page needs.
+ * found : Receives the page, -1 if no page has room.
+ *
+ * returns : RC_OK if the map was searched.
+ *			 pinPage errors if a map page cannot be pinned.
+ *
+ */
+
+static RC findPageWithRoom(RM_TableData *rel, int category, int *found)
+{
+	BM_PageHandle page;
+	int totalPages = ((Record_Manager *)rel->mgmtData)->table.numPages;
+	int mapPage, pageNum;
+	RC flag;
+
+	*found = -1;
+	for(mapPage = 1; mapPage < totalPages && *found < 0; mapPage = (mapPage == 1) ? FSM_ENTRIES : mapPage + FSM_ENTRIES)
+	{
+		flag = pinPageWithPriority(((Record_Manager *)rel->mgmtData)->bm, &page, mapPage, BM_PRIORITY_HOT);
+		if(flag != RC_OK)
+		{
+			return flag;
+		}
+		for(pageNum = (mapPage == 1) ? 0 : mapPage; pageNum < mapPage - (mapPage == 1) + FSM_ENTRIES && pageNum < totalPages; pageNum++)
+		{
+			int index = pageNum % FSM_ENTRIES;
+			int entry = FSM_MAP(page.data)[index / 2];
+			if(((index % 2 == 0) ? (entry & 0x0f) : (entry >> 4)) >= category)
+			{
+				*found = pageNum;
+				break;
+			}
+		}
+		unpinPage(((Record_Manager *)rel->mgmtData)->bm, &page);
+	}
+	return RC_OK;
+}
+
+/*
+ * Function: insertIntoPage
+ * ---------------------------
+ * This method stores a record on a heap page if it has room and keeps the free-space map up to date.
+ *
+ * rel : Management Structure for a Record Manager to handle one relation.
+ * pageNum : The heap page.
+ * record : The record, its id is set.
+ *
+ * returns : RC_OK if the record was stored.
+ *			 RC_RM_RECORD_TOO_LARGE if the page is full.
+ *			 pinPage errors if the page cannot be pinned.
+ *			 pinPage errors of the map or header page, the record is stored then but the map entry
+ *			 or the header on page 0 are behind until the next update.
+ *
+ */
+
+static RC insertIntoPage(RM_TableData *rel, int pageNum, Record *record)
+{
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	BM_PageHandle page;
+	int category;
+	RC flag, mapFlag = RC_OK;
+
+	flag = pinPageWithStrategy(rm_mgmt->bm, &page, pageNum, &rm_mgmt->insertRing);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	category = freeSpaceCategory(page.data);
+	record->id.page = pageNum;
+	record->id.slot = nextFreeSlot(page.data);
+	flag = storeTuple(page.data, record->id.slot, record->data, getRecordSize(rel->schema));
+	if(flag != RC_OK)
+	{
+		unpinPage(rm_mgmt->bm, &page);
+		return flag;
+	}
+	if(freeSpaceCategory(page.data) != category)
+	{
+		mapFlag = setFreeSpace(rel, pageNum, freeSpaceCategory(page.data));
+	}
+	logOperation(rel, LOG_SET_TUPLE, record->id, record->data, getRecordSize(rel->schema));
+	updatePageInfo(rel,&page);
+	rm_mgmt->table.numOfTuples += 1;
+	rm_mgmt->table.stats.inserts += 1;
+	flag = writeTableHeader(rel);
+	return (mapFlag != RC_OK) ? mapFlag : flag;
+}
+
+/*
+ * Function: attributeSize
+ * ---------------------------
+ * This method returns the number of bytes an attribute takes in a tuple.
+ *
+ * schema : Management structure to maintain schema details.
+ * attrNum : The attribute.
+ *
+ * returns : the size of the attribute.
+ *
+ */
+
+static int attributeSize (Schema *schema, int attrNum)
+{
+	switch (schema->dataTypes[attrNum])
+	{
+	case DT_STRING:
+		return schema->typeLength[attrNum];
+	case DT_INT:
+		return sizeof(int);
+	case DT_FLOAT:
+		return sizeof(float);
+	case DT_BOOL:
+		return sizeof(bool);
+	}
+	return 0;
+}
+
+/*
+ * Function: attrituteOffset
+ * ---------------------------
+ * This method calculates the offset associated with each attribute
+ * by taking size of each attribute datatype.
+ *
+ * schema : Management structure to maintain schema details.
+ * result : Used to store the offset.
+ * attrNum : Number of attributes.
+ *
+ * returns : RC_OK if all steps in attributeOffSet are successful.
+ *
+ */
+
+RC attrituteOffset (Schema *schema, int attrNum, int *result)
+{
+	int offset = 0;
+	int attrPosition = 0;
+
+	while(attrPosition < attrNum)
+	{
+		switch (schema->dataTypes[attrPosition])
+		{
+		case DT_STRING:
+			offset += schema->typeLength[attrPosition];
+			break;
+		case DT_INT:
+			offset += sizeof(int);
+			break;
+		case DT_FLOAT:
+			offset += sizeof(float);
+			break;
+		case DT_BOOL:
+			offset += sizeof(bool);
+			break;
+		}
+		attrPosition+=1;
+	}
+
+	*result = offset;
+	return RC_OK;
+}
+
+/*
+ * Function: initRecordManager
+ * ---------------------------
+ * This method initializes the record manager.
+ *
+ * returns : RC_OK as initialing is done and nothing is left to initialize.
+ *
+ */
+
+RC initRecordManager (void *mgmtData)
+{
+	printf("Initializing record manager done!\n");
+	return RC_OK;
+}
+
+/*
+ * Function: shutdownRecordManager
+ * ---------------------------
+ * This method shuts down the record manager.
+ *
+ * returns : RC_OK as memory is made free during allocation.
+ *
+ */
+RC shutdownRecordManager ()
+{
+	printf("Shutdown of record manager done!\n");
+	return RC_OK;
+}
+
+/*
+ * Function: redoOperation
+ * ---------------------------
+ * This method applies a redo record to a heap page. Applying a record twice, or to a page
+ * which already holds a later state of the slot, gives the same slot contents.
+ *
+ * data: Page data.
+ * logRecord: The record.
+ * tuple: Its tuple for LOG_SET_TUPLE.
+ *
+ * returns : void
+ */
+
+static void redoOperation(char *data, RM_LogRecord *logRecord, char *tuple)
+{
+	RM_PageHeader *header = PAGE_HEADER(data);
+	RM_Slot *slots = PAGE_SLOTS(data);
+
+	//a page appended after the last write of the file reads as zeros
+	if(header->numSlots == 0 && header->freeEnd == 0)
+	{
+		initHeapPage(data);
+	}
+	if(logRecord->slot < header->numSlots)
+	{
+		slots[logRecord->slot].offset = 0;
+		slots[logRecord->slot].length = 0;
+	}
+	if(logRecord->op != LOG_SET_TUPLE)
+	{
+		return;
+	}
+	if(logRecord->slot > header->numSlots)
+	{
+		//the slots in between were added by operations the page on disk already reflects
+		if(sizeof(RM_PageHeader) + (logRecord->slot + 1) * sizeof(RM_Slot) > header->freeEnd)
+		{
+			compactPage(data);
+		}
+		while(header->numSlots < logRecord->slot)
+		{
+			slots[header->numSlots].offset = 0;
+			slots[header->numSlots].length = 0;
+			header->numSlots += 1;
+		}
+	}
+	storeTuple(data, logRecord->slot, tuple, logRecord->length);
+}
+
+/*
+ * Function: recoverTable
+ * ---------------------------
+ * This method brings a table which was not closed after it was modified up to date:
+ * it replays the redo log of RM_WRITE_BACK mode onto the pages, recounts the tuples, rebuilds the
+ * free-space map from the heap pages and writes everything out. A torn record at the end of the log is ignored.
+ * In RM_WRITE_FORCE mode there is no log, the pages on disk are current and only the counts are redone.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ *
+ * returns : RC_OK if the table was recovered.
+ *			 pinPage or forceFlushPool errors if a page cannot be read or written, the log is kept
+ *			 and the next openTable recovers again then.
+ */
+
+static RC recoverTable(RM_TableData *rel)
+{
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	BM_PageHandle page;
+	SM_FileHandle fh;
+	RM_LogRecord logRecord;
+	char tuple[PAGE_SIZE];
+	FILE *log;
+	int pageNum, i, count = 0;
+	RC flag = RC_OK;
+
+	//the header may predate pages appended before the crash
+	if(openPageFile(rel->name, &fh) == RC_OK)
+	{
+		if(fh.totalNumPages > rm_mgmt->table.numPages)
+		{
+			rm_mgmt->table.numPages = fh.totalNumPages;
+		}
+		closePageFile(&fh);
+	}
+	//no forced writes while recovering, the pages are written once at the end
+	rm_mgmt->writePolicy = RM_WRITE_BACK;
+
+	log = fopen(rm_mgmt->logName, "rb");
+	while(log != NULL && fread(&logRecord, sizeof(RM_LogRecord), 1, log) == 1)
+	{
+		if(logRecord.length < 0 || logRecord.length > PAGE_SIZE
+				|| fread(tuple, 1, logRecord.length, log) != (size_t) logRecord.length)
+		{
+			break;
+		}
+		if(logRecord.page <= 0 || logRecord.slot < 0 || fsmPageOf(logRecord.page) == logRecord.page)
+		{
+			continue;
+		}
+		if(logRecord.page >= rm_mgmt->table.numPages)
+		{
+			rm_mgmt->table.numPages = logRecord.page + 1;
+		}
+		flag = pinPage(rm_mgmt->bm, &page, logRecord.page);
+		if(flag != RC_OK)
+		{
+			break;
+		}
+		redoOperation(page.data, &logRecord, tuple);
+		markDirty(rm_mgmt->bm, &page);
+		unpinPage(rm_mgmt->bm, &page);
+	}
+	if(log != NULL)
+	{
+		fclose(log);
+	}
+
+	for(pageNum = 1; pageNum < rm_mgmt->table.numPages && flag == RC_OK; pageNum++)
+	{
+		if(fsmPageOf(pageNum) == pageNum)
+		{
+			continue;
+		}
+		flag = pinPage(rm_mgmt->bm, &page, pageNum);
+		if(flag != RC_OK)
+		{
+			break;
+		}
+		if(PAGE_HEADER(page.data)->numSlots == 0 && PAGE_HEADER(page.data)->freeEnd == 0)
+		{
+			initHeapPage(page.data);
+			markDirty(rm_mgmt->bm, &page);
+		}
+		for(i = 0; i < PAGE_HEADER(page.data)->numSlots; i++)
+		{
+			count += (PAGE_SLOTS(page.data)[i].length != 0);
+		}
+		i = freeSpaceCategory(page.data);
+		unpinPage(rm_mgmt->bm, &page);
+		flag = setFreeSpace(rel, pageNum, i);
+	}
+	if(flag == RC_OK)
+	{
+		rm_mgmt->table.numOfTuples = count;
+		flag = writeTableHeader(rel);
+	}
+	if(flag == RC_OK)
+	{
+		flag = forceFlushPool(rm_mgmt->bm);
+	}
+	rm_mgmt->writePolicy = RM_WRITE_FORCE;
+	if(flag != RC_OK)
+	{
+		//the header on disk still asks for recovery, replaying the log again is harmless
+		return flag;
+	}
+	remove(rm_mgmt->logName);
+	rm_mgmt->table.needsRecovery = 0;
+	return forceTableHeader(rel);
+}
+
+/*
+ * Function: createTable
+ * ---------------------------
+ * This function is used to Create a Table.
+ * Create the underlying page file and store information about the schema, free-space, ...
+ * and so on in the Table Information pages.
+ *
+ * name: Name of the relation/table.
+ * schema: Schema of the table.
+ *
+ * returns : RC_FILE_NOT_FOUND if pagefile creation of opening fails.
+ *					 RC_WRITE_FAILED if write operation for writing serialized data fails.
+ * 					 RC_OK if all steps are executed and table is created.
+ *
+ */
+RC createTable (char *name, Schema *schema)
+{
+	SM_FileHandle filehandle;
+ 	char *serializedData = serializeSchema(schema);
+	char *schemaPage = (char*)calloc(PAGE_SIZE,sizeof(char));
+	RecordMgr_Table tableInfo;
+	int i;
+	for(i=0;i<sizeof(serializedData); i++){
+		printf("%c ",serializedData[i]);
+	}
+
+ 	RC createPageFlag = createPageFile(name);
+ 	RC openPageFlag = openPageFile(name,&filehandle);
+ 	if(createPageFlag!=RC_OK || openPageFlag!=RC_OK)
+ 	{
+ 		return RC_FILE_NOT_FOUND;
+ 	}
+
+ 	//page 0 holds the table header and the schema behind it
+ 	memset(&tableInfo, 0, sizeof(RecordMgr_Table));
+ 	memcpy(tableInfo.magic, RM_TABLE_MAGIC, 4);
+ 	tableInfo.numPages = 2;
+ 	tableInfo.fsmRoot = 1;
+ 	tableInfo.schemaSize = strlen(serializedData);
+ 	if(sizeof(RecordMgr_Table) + tableInfo.schemaSize >= PAGE_SIZE)
+ 	{
+ 		closePageFile(&filehandle);
+ 		free(schemaPage);
+ 		return RC_WRITE_FAILED;
+ 	}
+ 	memcpy(schemaPage, &tableInfo, sizeof(RecordMgr_Table));
+ 	memcpy(schemaPage + sizeof(RecordMgr_Table), serializedData, tableInfo.schemaSize);
+ 	RC writeflag = writeBlock(0,&filehandle,schemaPage);
+ 	//page 1 is the first free-space map page, all pages start out full
+ 	memset(schemaPage, 0, PAGE_SIZE);
+ 	if(writeflag == RC_OK)
+ 	{
+ 		ensureCapacity(2, &filehandle);
+ 		writeflag = writeBlock(1,&filehandle,schemaPage);
+ 	}
+ 	closePageFile(&filehandle);
+ 	free(schemaPage);
+ 	if(writeflag!=RC_OK)
+ 	{
+ 		return RC_WRITE_FAILED;
+ 	}
+	return RC_OK;
+}
+
+/*
+* Function: openTable
+* ---------------------------
+* This function is used to Open a table which is already created with name. This should have a pageFile created.
+* For any operation to be performed, the table has to be opened first.
+*
+* name: Name of the relation/table.
+* rel: Management Structure for a Record Manager to handle one relation.
+*
+* returns : RC_OK if all steps are executed and table is opened.
+*/
+RC openTable (RM_TableData *rel, char *name)
+{
+	Record_Manager *rm_mgmt = (Record_Manager*)malloc(sizeof(Record_Manager));
+	rm_mgmt->bm = MAKE_POOL();
+
+	//Make a Page Handle
+	BM_PageHandle *page = MAKE_PAGE_HANDLE();
+	//use the global buffer pool when the application set one up, a private one otherwise
+	if(initSharedBufferPool(rm_mgmt->bm,name) != RC_OK)
+	{
+		initBufferPool(rm_mgmt->bm,name,6,RS_FIFO,NULL);
+	}
+	//the header page is read by every open and written by inserts and deletes, keep it resident but do not hold the pin
+	SM_FileHandle fh;
+	RC flag = pinPageWithPriority(rm_mgmt->bm,page,0,BM_PRIORITY_HOT);
+	if(flag == RC_OK)
+	{
+		memcpy(&rm_mgmt->table, page->data, sizeof(RecordMgr_Table));
+		if(memcmp(rm_mgmt->table.magic, RM_TABLE_MAGIC, 4) != 0)
+		{
+			unpinPage(rm_mgmt->bm,page);
+			flag = RC_RM_BAD_TABLE_HEADER;
+		}
+	}
+	if(flag != RC_OK)
+	{
+		shutdownBufferPool(rm_mgmt->bm);
+		free(rm_mgmt->bm);
+		free(rm_mgmt);
+		free(page);
+		return flag;
+	}
+	//deserializeSchema tokenizes its input, parse a copy
+	char *schemaPage = (char*)calloc(rm_mgmt->table.schemaSize + 1, sizeof(char));
+	memcpy(schemaPage, page->data + sizeof(RecordMgr_Table), rm_mgmt->table.schemaSize);
+	unpinPage(rm_mgmt->bm,page);
+	initAccessStrategy(&rm_mgmt->insertRing, INSERT_RING_SIZE);
+	rm_mgmt->freePages = (int*)malloc(sizeof(int));
+	//no page with room known yet, the first insert asks the free-space map
+	rm_mgmt->freePages[0] = -1;
+	rel->schema = deserializeSchema(schemaPage);
+	rel->name = name;
+	rel->mgmtData = rm_mgmt;
+	rm_mgmt->writePolicy = RM_WRITE_FORCE;
+	rm_mgmt->log = NULL;
+	rm_mgmt->logName = (char *) malloc(strlen(name) + 5);
+	sprintf(rm_mgmt->logName, "%s.log", name);
+	free(schemaPage);
+	free(page);
+	//pages appended after the header was last written, count them in
+	if(!rm_mgmt->table.needsRecovery && openPageFile(name, &fh) == RC_OK)
+	{
+		rm_mgmt->table.needsRecovery = (fh.totalNumPages > rm_mgmt->table.numPages);
+		closePageFile(&fh);
+	}
+	if(rm_mgmt->table.needsRecovery)
+	{
+		flag = recoverTable(rel);
+		if(flag != RC_OK)
+		{
+			//give the table up without writing its header, which still asks for recovery
+			shutdownBufferPool(rm_mgmt->bm);
+			freeAccessStrategy(&rm_mgmt->insertRing);
+			free(rm_mgmt->freePages);
+			free(rm_mgmt->logName);
+			free(rm_mgmt->bm);
+			free(rm_mgmt);
+			freeSchema(rel->schema);
+			return flag;
+		}
+	}
+	return RC_OK;
+}
+
+/*
+* Function: closeTable
+* ---------------------------
+* The table is closed after all the operations are completed.
+* All the memory allocations are de-allocated to avoid memory leaks.
+*
+* rel: Management Structure for a Record Manager to handle one relation.
+*
+* returns : RC_OK after all memory allocations are de-allocated and table is closed.
+*					shutdownBufferPool errors, e.g. while records are still pinned in the global pool, the table stays open then.
+*					setWritePolicy errors if the checkpoint of a table in RM_WRITE_BACK mode fails, the table stays open then.
+*/
+RC closeTable (RM_TableData *rel)
+{
+	printf(" Entered close Table \n");
+	Record_Manager *rmgmt = (Record_Manager*)malloc(sizeof(Record_Manager));
+	rmgmt = rel->mgmtData;
+	//a clean close leaves nothing to recover
+	RC shutdownFlag = setWritePolicy(rel, RM_WRITE_FORCE);
+	if(shutdownFlag != RC_OK)
+	{
+		return shutdownFlag;
+	}
+	int needsRecovery = rmgmt->table.needsRecovery;
+	rmgmt->table.needsRecovery = 0;
+	shutdownFlag = writeTableHeader(rel);
+	if(shutdownFlag == RC_OK)
+	{
+		shutdownFlag = shutdownBufferPool(rmgmt->bm);
+	}
+	if(shutdownFlag != RC_OK)
+	{
+		//the table stays open, its header must keep asking for recovery
+		rmgmt->table.needsRecovery = needsRecovery;
+		writeTableHeader(rel);
+		return shutdownFlag;
+	}
+	freeAccessStrategy(&rmgmt->insertRing);
+	free(rmgmt->logName);
+	free(rmgmt);
+	free(rel->schema->attrNames);
+	free(rel->schema->dataTypes);
+	free(rel->schema->keyAttrs);
+	free(rel->schema->typeLength);
+
+	free(rel->schema);
+
+	return RC_OK;
+}
+
+/*
+* Function: deleteTable
+* ---------------------------
+* This function deletes the table using destroyPageFile function from buffermanager.
+*
+* name: Name of the relation/table.
+*
+* returns : RC_OK if destroy pagefile is successful.
+*					RC_FILE_NOT_FOUND if file is pagefile is not found.
+*/
+
+RC deleteTable (char *name)
+{
+	printf("Entered Delete ");
+	char logName[strlen(name) + 5];
+	sprintf(logName, "%s.log", name);
+	remove(logName);
+	RC destroyFlag = destroyPageFile(name);
+	if(destroyFlag == RC_OK)
+	{
+		return RC_OK;
+	}
+	else{
+		return RC_FILE_NOT_FOUND;
+	}
+}
+
+/*
+* Function: getNumTuples
+* ---------------------------
+* This function is used to get number of tuples/rows in the table.
+*
+* rel: Management Structure for a Record Manager to handle one relation.
+*
+* returns : the tuple count kept in the table header.
+*/
+
+int getNumTuples (RM_TableData *rel)
+{
+	return ((Record_Manager *)rel->mgmtData)->table.numOfTuples;
+}
+
+/*
+ * Function: getTableStats
+ * ---------------------------
+ * This function copies the operation counters of a table into a caller supplied struct.
+ * The counters are kept in the table header and survive closing the table.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * stats: Filled with the counters.
+ *
+ * returns : RC_OK
+ */
+
+RC getTableStats (RM_TableData *rel, RM_TableStats *stats)
+{
+	*stats = ((Record_Manager *)rel->mgmtData)->table.stats;
+	return RC_OK;
+}
+
+/*
+ * Function: setWritePolicy
+ * ---------------------------
+ * This function chooses how modifications of a table reach the disk.
+ * RM_WRITE_FORCE writes every modified page before the call returns, the default of an opened table.
+ * RM_WRITE_BACK leaves modified pages dirty in the buffer pool, they are written by eviction,
+ * flushes and checkpointTable. Each insert, update and delete appends a redo record to the
+ * table's log file <name>.log instead. If the process dies, the next openTable replays the log.
+ * After a system crash, changes since the last syncTableLog may be lost.
+ * Switching back to RM_WRITE_FORCE checkpoints the table and removes the log.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * policy: The policy.
+ *
+ * returns : RC_OK if the policy is set.
+ *			 RC_FILE_NOT_FOUND if the log cannot be created.
+ *			 checkpointTable errors if the checkpoint fails, the table stays in RM_WRITE_BACK then.
+ */
+
+RC setWritePolicy (RM_TableData *rel, RM_WritePolicy policy)
+{
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	RC flag;
+
+	if(policy == rm_mgmt->writePolicy)
+	{
+		return RC_OK;
+	}
+	if(policy == RM_WRITE_BACK)
+	{
+		rm_mgmt->log = fopen(rm_mgmt->logName, "wb");
+		if(rm_mgmt->log == NULL)
+		{
+			return RC_FILE_NOT_FOUND;
+		}
+		//pages written from now on may be ahead of the header, open must recover
+		rm_mgmt->table.needsRecovery = 1;
+		flag = forceTableHeader(rel);
+		if(flag != RC_OK)
+		{
+			rm_mgmt->table.needsRecovery = 0;
+			fclose(rm_mgmt->log);
+			rm_mgmt->log = NULL;
+			remove(rm_mgmt->logName);
+			return flag;
+		}
+		rm_mgmt->writePolicy = RM_WRITE_BACK;
+		return RC_OK;
+	}
+
+	flag = checkpointTable(rel);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	fclose(rm_mgmt->log);
+	rm_mgmt->log = NULL;
+	remove(rm_mgmt->logName);
+	rm_mgmt->writePolicy = RM_WRITE_FORCE;
+	rm_mgmt->table.needsRecovery = 0;
+	return forceTableHeader(rel);
+}
+
+/*
+ * Function: syncTableLog
+ * ---------------------------
+ * This function makes the logged modifications of a table in RM_WRITE_BACK mode durable
+ * against system crashes, the point a caller commits its changes.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ *
+ * returns : RC_OK
+ *			 RC_WRITE_FAILED if the log cannot be synced.
+ */
+
+RC syncTableLog (RM_TableData *rel)
+{
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+
+	if(rm_mgmt->log == NULL)
+	{
+		return RC_OK;
+	}
+	if(fflush(rm_mgmt->log) != 0 || fsync(fileno(rm_mgmt->log)) != 0)
+	{
+		return RC_WRITE_FAILED;
+	}
+	return RC_OK;
+}
+
+/*
+ * Function: checkpointTable
+ * ---------------------------
+ * This function writes the dirty pages and the header of a table and, in RM_WRITE_BACK mode,
+ * empties its redo log, which then has nothing left to replay. It must not run concurrently with
+ * modifications of the table.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ *
+ * returns : RC_OK if the table is written.
+ *			 forceFlushPool errors if a page cannot be written, the log is kept then.
+ *			 RC_BM_FRAMES_PINNED if a modified page is pinned, e.g. by pinRecord or a scan, and cannot
+ *			 be written, the log is kept then.
+ */
+
+RC checkpointTable (RM_TableData *rel)
+{
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	RC flag;
+
+	flag = writeTableHeader(rel);
+	if(flag == RC_OK)
+	{
+		flag = forceFlushPool(rm_mgmt->bm);
+	}
+	//forceFlushPool passes over pinned pages, the log still has to redo their changes
+	if(flag == RC_OK && getNumDirtyPages(rm_mgmt->bm) != 0)
+	{
+		flag = RC_BM_FRAMES_PINNED;
+	}
+	if(flag != RC_OK || rm_mgmt->log == NULL)
+	{
+		return flag;
+	}
+	rm_mgmt->log = freopen(rm_mgmt->logName, "wb", rm_mgmt->log);
+	return (rm_mgmt->log != NULL) ? RC_OK : RC_WRITE_FAILED;
+}
+
+/*
+ * Function: insertRecord
+ * ---------------------------
+ * This function is used to insert a new record into the table.
+ * When a new record is inserted the record manager should assign an
+ * RID to this record and update the record parameter passed to insertRecord .
+ * The record goes to the page an earlier insert or delete left room on, else to a page the
+ * free-space map knows to have room, else to a new page.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * record: Management Structure for Record which has rid and data of a tuple.
+ *
+ * returns : RC_OK if destroy getRecord is successful.
+ *			 RC_RM_RECORD_TOO_LARGE if the record does not fit on a page.
+ *			 pinPage errors if a page cannot be pinned, see insertIntoPage.
+ */
+
+RC insertRecord (RM_TableData *rel, Record *record)
+{
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	BM_PageHandle page;
+	int len = getRecordSize(rel->schema);
+	int category = (len + sizeof(RM_Slot) + FSM_UNIT - 1) / FSM_UNIT;
+	int pageNum;
+	RC flag;
+
+	if(len > PAGE_SIZE - (int) (sizeof(RM_PageHeader) + sizeof(RM_Slot)))
+	{
+		return RC_RM_RECORD_TOO_LARGE;
+	}
+	flag = markTableModified(rel);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	//the page the last insert or delete left room on
+	if(rm_mgmt->freePages[0] > 0 && rm_mgmt->freePages[0] < rm_mgmt->table.numPages)
+	{
+		flag = insertIntoPage(rel, rm_mgmt->freePages[0], record);
+		if(flag != RC_RM_RECORD_TOO_LARGE)
+		{
+			return flag;
+		}
+	}
+	flag = findPageWithRoom(rel, category, &pageNum);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	if(pageNum > 0)
+	{
+		flag = insertIntoPage(rel, pageNum, record);
+		if(flag != RC_RM_RECORD_TOO_LARGE)
+		{
+			rm_mgmt->freePages[0] = pageNum;
+			return flag;
+		}
+	}
+
+	//no page has room, append one, and a map page first when the map needs one
+	if(fsmPageOf(rm_mgmt->table.numPages) == rm_mgmt->table.numPages)
+	{
+		flag = pinPageWithPriority(rm_mgmt->bm, &page, rm_mgmt->table.numPages, BM_PRIORITY_HOT);
+		if(flag != RC_OK)
+		{
+			return flag;
+		}
+		memset(page.data, 0, PAGE_SIZE);
+		updatePageInfo(rel,&page);
+		rm_mgmt->table.numPages+=1;
+	}
+	//appended pages are written once, recycle a few frames instead of pushing the working set out
+	flag = pinPageWithStrategy(rm_mgmt->bm, &page, rm_mgmt->table.numPages, &rm_mgmt->insertRing);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	initHeapPage(page.data);
+	updatePageInfo(rel,&page);
+	rm_mgmt->freePages[0] = rm_mgmt->table.numPages;
+	rm_mgmt->table.numPages+=1;
+	rm_mgmt->table.stats.pagesAppended += 1;
+	return insertIntoPage(rel, rm_mgmt->freePages[0], record);
+}
+
+/*
+ * Function: flushExtent
+ * ---------------------------
+ * This method appends the extent pages of a bulk load to the table file with one write,
+ * records their free space in the map and updates the table header once for all of them.
+ *
+ * loader: The bulk load.
+ *
+ * returns : RC_OK if the pages were written.
+ *			 openPageFile or writeBlocks errors if the write fails, the extent is kept then.
+ *
+ */
+
+static RC flushExtent(RM_BulkLoader *loader)
+{
+	Record_Manager *rm_mgmt = (Record_Manager *)loader->rel->mgmtData;
+	RecordMgr_BulkMgmt *bulk = (RecordMgr_BulkMgmt *)loader->mgmtData;
+	char *pages[BULK_EXTENT_PAGES];
+	SM_FileHandle fh;
+	int i, pageNum, category, lastPage = -1;
+	RC flag;
+
+	if(bulk->usedPages == 0)
+	{
+		return RC_OK;
+	}
+	for(i = 0; i < bulk->usedPages; i++)
+	{
+		pages[i] = bulk->extent + i * PAGE_SIZE;
+		pageNum = bulk->firstPage + i;
+		if(fsmPageOf(pageNum) == pageNum)
+		{
+			continue;
+		}
+		lastPage = pageNum;
+		//a new page starts out full in the map, only pages with room need an entry
+		category = freeSpaceCategory(pages[i]);
+		if(category != 0 && fsmPageOf(pageNum) >= bulk->firstPage)
+		{
+			setMapEntry(bulk->extent + (fsmPageOf(pageNum) - bulk->firstPage) * PAGE_SIZE, pageNum, category);
+		}
+		else if(category != 0)
+		{
+			flag = setFreeSpace(loader->rel, pageNum, category);
+			if(flag != RC_OK)
+			{
+				return flag;
+			}
+		}
+	}
+
+	//the pages lie behind the end of the table, no frame of the pool holds them
+	flag = openPageFile(loader->rel->name, &fh);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	ensureCapacity(bulk->firstPage + bulk->usedPages, &fh);
+	flag = writeBlocks(bulk->firstPage, bulk->usedPages, &fh, pages);
+	closePageFile(&fh);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+
+	rm_mgmt->table.numPages = bulk->firstPage + bulk->usedPages;
+	rm_mgmt->table.numOfTuples += bulk->numTuples;
+	rm_mgmt->table.stats.inserts += bulk->numTuples;
+	rm_mgmt->table.stats.pagesAppended += bulk->heapPages;
+	flag = writeTableHeader(loader->rel);
+	//later inserts continue on the last page if it has room
+	if(lastPage > 0 && freeSpaceCategory(pages[lastPage - bulk->firstPage]) != 0)
+	{
+		rm_mgmt->freePages[0] = lastPage;
+	}
+
+	bulk->firstPage += bulk->usedPages;
+	bulk->usedPages = 0;
+	bulk->numTuples = 0;
+	bulk->heapPages = 0;
+	return flag;
+}
+
+/*
+ * Function: newExtentPage
+ * ---------------------------
+ * This method starts a new empty heap page in the extent of a bulk load, behind a new map page
+ * when the map needs one. A full extent is written first.
+ *
+ * loader: The bulk load.
+ * data: Set to the data of the new page.
+ *
+ * returns : RC_OK if the page was added.
+ *			 flushExtent errors if writing the full extent fails.
+ *
+ */
+
+static RC newExtentPage(RM_BulkLoader *loader, char **data)
+{
+	RecordMgr_BulkMgmt *bulk = (RecordMgr_BulkMgmt *)loader->mgmtData;
+	int pageNum = bulk->firstPage + bulk->usedPages;
+	RC flag;
+
+	if(bulk->usedPages + 2 > BULK_EXTENT_PAGES)
+	{
+		flag = flushExtent(loader);
+		if(flag != RC_OK)
+		{
+			return flag;
+		}
+		pageNum = bulk->firstPage;
+	}
+	if(fsmPageOf(pageNum) == pageNum)
+	{
+		memset(bulk->extent + bulk->usedPages * PAGE_SIZE, 0, PAGE_SIZE);
+		bulk->usedPages += 1;
+	}
+	*data = bulk->extent + bulk->usedPages * PAGE_SIZE;
+	initHeapPage(*data);
+	bulk->usedPages += 1;
+	bulk->heapPages += 1;
+	return RC_OK;
+}
+
+/*
+ * Function: startBulkLoad
+ * ---------------------------
+ * This function starts a bulk load which appends records to the end of a table.
+ * The records are packed into pages in memory and the pages are written to the file
+ * BULK_EXTENT_PAGES at a time, bypassing the buffer pool. Other inserts into the table
+ * must wait until finishBulkLoad.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * loader: holds the bulk load management data.
+ *
+ * returns : RC_OK
+ *			 markTableModified errors if the header cannot be written.
+ */
+
+RC startBulkLoad (RM_TableData *rel, RM_BulkLoader *loader)
+{
+	RecordMgr_BulkMgmt *bulk;
+	RC flag = markTableModified(rel);
+
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	bulk = (RecordMgr_BulkMgmt *) malloc (sizeof(RecordMgr_BulkMgmt));
+	bulk->extent = (char *) malloc (BULK_EXTENT_PAGES * PAGE_SIZE);
+	bulk->firstPage = ((Record_Manager *)rel->mgmtData)->table.numPages;
+	bulk->usedPages = 0;
+	bulk->numTuples = 0;
+	bulk->heapPages = 0;
+
+	loader->rel = rel;
+	loader->mgmtData = bulk;
+	return RC_OK;
+}
+
+/*
+ * Function: bulkLoadRecord
+ * ---------------------------
+ * This function adds a record to a bulk load and sets its RID. The record is on disk and
+ * counted by getNumTuples once its extent is written, at the latest by finishBulkLoad.
+ *
+ * loader: holds the bulk load management data.
+ * record: The record.
+ *
+ * returns : RC_OK if the record was added.
+ *			 RC_RM_RECORD_TOO_LARGE if the record does not fit on a page.
+ *			 flushExtent errors if writing a full extent fails.
+ */
+
+RC bulkLoadRecord (RM_BulkLoader *loader, Record *record)
+{
+	RecordMgr_BulkMgmt *bulk = (RecordMgr_BulkMgmt *)loader->mgmtData;
+	int len = getRecordSize(loader->rel->schema);
+	char *data = bulk->extent + (bulk->usedPages - 1) * PAGE_SIZE;
+	RC flag;
+
+	if(len > PAGE_SIZE - (int) (sizeof(RM_PageHeader) + sizeof(RM_Slot)))
+	{
+		return RC_RM_RECORD_TOO_LARGE;
+	}
+	if(bulk->usedPages == 0 || storeTuple(data, PAGE_HEADER(data)->numSlots, record->data, len) != RC_OK)
+	{
+		flag = newExtentPage(loader, &data);
+		if(flag != RC_OK)
+		{
+			return flag;
+		}
+		storeTuple(data, 0, record->data, len);
+	}
+	record->id.page = bulk->firstPage + bulk->usedPages - 1;
+	record->id.slot = PAGE_HEADER(data)->numSlots - 1;
+	bulk->numTuples += 1;
+	return RC_OK;
+}
+
+/*
+ * Function: buildHeapPage
+ * ---------------------------
+ * This function formats a heap page holding consecutive tuples, for loaders which build
+ * pages in parallel and append them with bulkLoadPage.
+ *
+ * schema: Schema of the tuples.
+ * page: PAGE_SIZE bytes, overwritten.
+ * tuples: n tuples of getRecordSize bytes each.
+ * n: Number of tuples.
+ *
+ * returns : the number of tuples stored, the first ones of tuples.
+ */
+
+int buildHeapPage (Schema *schema, char *page, char *tuples, int n)
+{
+	int len = getRecordSize(schema);
+	int i;
+
+	initHeapPage(page);
+	for(i = 0; i < n; i++)
+	{
+		if(storeTuple(page, i, tuples + i * len, len) != RC_OK)
+		{
+			break;
+		}
+	}
+	return i;
+}
+
+/*
+ * Function: bulkLoadPage
+ * ---------------------------
+ * This function adds a heap page built by buildHeapPage to a bulk load.
+ * RIDs of its tuples are the page number it gets and their index on the page.
+ *
+ * loader: holds the bulk load management data.
+ * page: The page, copied.
+ *
+ * returns : RC_OK if the page was added.
+ *			 flushExtent errors if writing a full extent fails.
+ */
+
+RC bulkLoadPage (RM_BulkLoader *loader, char *page)
+{
+	RecordMgr_BulkMgmt *bulk = (RecordMgr_BulkMgmt *)loader->mgmtData;
+	char *data;
+	RC flag = newExtentPage(loader, &data);
+
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	memcpy(data, page, PAGE_SIZE);
+	bulk->numTuples += PAGE_HEADER(page)->numSlots;
+	return RC_OK;
+}
+
+/*
+ * Function: finishBulkLoad
+ * ---------------------------
+ * This function writes the remaining pages of a bulk load and frees its management data.
+ *
+ * loader: holds the bulk load management data.
+ *
+ * returns : RC_OK if all records were written.
+ *			 flushExtent errors if the last write fails.
+ */
+
+RC finishBulkLoad (RM_BulkLoader *loader)
+{
+	RecordMgr_BulkMgmt *bulk = (RecordMgr_BulkMgmt *)loader->mgmtData;
+	RC flag = flushExtent(loader);
+
+	free(bulk->extent);
+	free(bulk);
+	loader->mgmtData = NULL;
+	return flag;
+}
+
+/*
+ * Function: insertRecords
+ * ---------------------------
+ * This function appends n records to the table with a bulk load and sets their RIDs.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * records: The records.
+ * n: Number of records.
+ *
+ * returns : RC_OK if all records were inserted.
+ *			 bulkLoadRecord or finishBulkLoad errors otherwise, the records before the failing one are inserted.
+ */
+
+RC insertRecords (RM_TableData *rel, Record **records, int n)
+{
+	RM_BulkLoader loader;
+	RC flag, finishFlag;
+	int i;
+
+	flag = startBulkLoad(rel, &loader);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	for(i = 0; i < n && flag == RC_OK; i++)
+	{
+		flag = bulkLoadRecord(&loader, records[i]);
+	}
+	finishFlag = finishBulkLoad(&loader);
+	return (flag != RC_OK) ? flag : finishFlag;
+}
+
+/*
+ * Function: deleteRecord
+ * ---------------------------
+ * This function is used to delete a record from the table.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * id: rid to be deleted.
+ *
+ * returns : RC_OK if delete record is successful.
+ *					 RC_RM_NO_MORE_TUPLES if no tuples are available to delete.
+ *					 RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD if the record is deleted already.
+ *					 pinPage errors if the page cannot be pinned, or if the map or header page cannot
+ *					 be pinned after the record was deleted.
+ */
+RC deleteRecord (RM_TableData *rel, RID id)
+{
+
+	if(id.page > 0 && id.page < ((Record_Manager *)rel->mgmtData)->table.numPages)
+	{
+		BM_PageHandle page;
+		RC flag, mapFlag = RC_OK;
+		flag = markTableModified(rel);
+		if(flag == RC_OK)
+		{
+			flag = pinPage(((Record_Manager *)rel->mgmtData)->bm, &page, id.page);
+		}
+		if(flag != RC_OK)
+		{
+			return flag;
+		}
+		if(id.slot < 0 || id.slot >= PAGE_HEADER(page.data)->numSlots)
+		{
+			unpinPage(((Record_Manager *)rel->mgmtData)->bm, &page);
+			return RC_RM_NO_MORE_TUPLES;
+		}
+		//Cannot delete already deleted record
+		if(PAGE_SLOTS(page.data)[id.slot].length == 0)
+		{
+			unpinPage(((Record_Manager *)rel->mgmtData)->bm, &page);
+			return RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD;
+		}
+		//free the slot, its bytes are reclaimed when the page is compacted
+		int category = freeSpaceCategory(page.data);
+		PAGE_SLOTS(page.data)[id.slot].offset = 0;
+		PAGE_SLOTS(page.data)[id.slot].length = 0;
+		if(freeSpaceCategory(page.data) != category)
+		{
+			mapFlag = setFreeSpace(rel, id.page, freeSpaceCategory(page.data));
+			//fill the hole before appending pages
+			if(freeSpaceCategory(page.data) * FSM_UNIT >= getRecordSize(rel->schema) + (int) sizeof(RM_Slot))
+			{
+				((Record_Manager *)rel->mgmtData)->freePages[0] = id.page;
+			}
+		}
+		logOperation(rel, LOG_FREE_SLOT, id, NULL, 0);
+		updatePageInfo(rel,&page);
+		((Record_Manager *)rel->mgmtData)->table.numOfTuples -= 1;
+		((Record_Manager *)rel->mgmtData)->table.stats.deletes += 1;
+		flag = writeTableHeader(rel);
+		return (mapFlag != RC_OK) ? mapFlag : flag;
+	}
+	else
+	{
+		return RC_RM_NO_MORE_TUPLES;
+	}
+
+	return RC_OK;
+}
+
+
+/*
+ * Function: updateRecord
+ * ---------------------------
+ * This function is used to update a record in the table.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * record: Management Structure for a Record to store rid and data of a tuple.
+ *
+ * returns : RC_OK if delete record is successful.
+ *					 RC_RM_NO_MORE_TUPLES if no tuples are available to update.
+ *					 RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD if the record is deleted.
+ *					 pinPage errors if the page cannot be pinned.
+ */
+
+RC updateRecord (RM_TableData *rel, Record *record)
+{
+	// Check boundary conditions for tuple availability
+	if(record->id.page <= 0 || record->id.page >= ((Record_Manager *)rel->mgmtData)->table.numPages)
+	{
+		return RC_RM_NO_MORE_TUPLES;
+	}
+	else
+	{
+		BM_PageHandle page;
+		RM_Slot *slot;
+		RC flag;
+
+		flag = pinPage(((Record_Manager *)rel->mgmtData)->bm, &page, record->id.page);
+		if(flag != RC_OK)
+		{
+			return flag;
+		}
+		if(record->id.slot < 0 || record->id.slot >= PAGE_HEADER(page.data)->numSlots
+				|| PAGE_SLOTS(page.data)[record->id.slot].length == 0)
+		{
+			unpinPage(((Record_Manager *)rel->mgmtData)->bm, &page);
+			return RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD;
+		}
+		//records have a fixed size, the new version overwrites the old one
+		slot = &PAGE_SLOTS(page.data)[record->id.slot];
+		memcpy(page.data + slot->offset, record->data, slot->length);
+		logOperation(rel, LOG_SET_TUPLE, record->id, record->data, slot->length);
+		updatePageInfo(rel,&page);
+		((Record_Manager *)rel->mgmtData)->table.stats.updates += 1;
+		return RC_OK;
+	}
+
+	return RC_OK;
+}
+
+/*
+ * Function: getRecord
+ * ---------------------------
+ * This function is used to get a record from the table using rid.
+ * The attributes are copied into record->data, which the caller allocates, e.g. with createRecord.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * rid: Record identifier.
+ * record: Management Structure for a Record to store rid and data of a tuple.
+ *
+ * returns : RC_OK if delete record is successful.
+ *					 RC_RM_NO_MORE_TUPLES if no tuples are available to update.
+ *
+ */
+
+RC getRecord (RM_TableData *rel, RID id, Record *record)
+{
+	return fetchRecord(rel, id, record, NULL);
+}
+
+/*
+ * Function: fetchRecord
+ * ---------------------------
+ * This function implements getRecord, pinning the page through an access strategy if one is given.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * rid: Record identifier.
+ * record: Management Structure for a Record to store rid and data of a tuple.
+ * ring: ring of frames of a scan, or NULL to use the buffer pool's replacement policy.
+ *
+ * returns : the return codes of getRecord.
+ *
+ */
+
+static RC fetchRecord (RM_TableData *rel, RID id, Record *record, BM_AccessStrategy *ring)
+{
+	BM_PageHandle page;
+	char *tuple;
+	RC flag;
+
+	record->id = id;
+	flag = pinSlot(rel, id, ring, &page, &tuple);
+	if(flag == RC_OK)
+	{
+		memcpy(record->data, tuple, PAGE_SLOTS(page.data)[id.slot].length);
+		unpinPage(((Record_Manager *)rel->mgmtData)->bm, &page);
+	}
+	return flag;
+}
+
+/*
+ * Function: pinSlot
+ * ---------------------------
+ * This function pins the page of a record and finds the tuple on it.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * id: Record identifier.
+ * ring: ring of frames of a scan, or NULL to use the buffer pool's replacement policy.
+ * page: Receives the pinned page.
+ * tuple: Receives the address of the tuple in the page.
+ *
+ * returns : RC_OK if the record exists, the page stays pinned then.
+ *			 RC_RM_NO_MORE_TUPLES if the page or slot does not exist.
+ *			 RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD if the record is deleted.
+ *			 pinPage errors if the page cannot be pinned.
+ *
+ */
+
+static RC pinSlot (RM_TableData *rel, RID id, BM_AccessStrategy *ring, BM_PageHandle *page, char **tuple)
+{
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	RC flag;
+
+	if(id.page <= 0 || id.page >= rm_mgmt->table.numPages)
+	{
+		return RC_RM_NO_MORE_TUPLES;
+	}
+	flag = pinPageWithStrategy(rm_mgmt->bm, page, id.page, ring);
+	if(flag != RC_OK)
+	{
+		return flag;
+	}
+	if(id.slot < 0 || id.slot >= PAGE_HEADER(page->data)->numSlots)
+	{
+		unpinPage(rm_mgmt->bm, page);
+		return RC_RM_NO_MORE_TUPLES;
+	}
+	if(PAGE_SLOTS(page->data)[id.slot].length == 0)
+	{
+		unpinPage(rm_mgmt->bm, page);
+		return RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD;
+	}
+	*tuple = page->data + PAGE_SLOTS(page->data)[id.slot].offset;
+	return RC_OK;
+}
+
+/*
+ * Function: pinRecord
+ * ---------------------------
+ * This function is a getRecord without copying: record->data is pointed at the tuple in the
+ * buffer pool frame, which stays pinned until releaseRecord. Pass a record without its own data,
+ * e.g. one on the stack, and do not modify the tuple through it.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * id: Record identifier.
+ * record: Receives the rid and the address of the tuple.
+ *
+ * returns : RC_OK if the record is pinned.
+ *			 RC_RM_NO_MORE_TUPLES if the page or slot does not exist.
+ *			 RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD if the record is deleted.
+ */
+
+RC pinRecord (RM_TableData *rel, RID id, Record *record)
+{
+	BM_PageHandle page;
+
+	record->id = id;
+	return pinSlot(rel, id, NULL, &page, &record->data);
+}
+
+/*
+ * Function: releaseRecord
+ * ---------------------------
+ * This function unpins the page of a record returned by pinRecord. record->data is invalid afterwards.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * record: The record.
+ *
+ * returns : RC_OK
+ */
+
+RC releaseRecord (RM_TableData *rel, Record *record)
+{
+	BM_PageHandle page;
+
+	page.pageNum = record->id.page;
+	page.data = NULL;
+	unpinPage(((Record_Manager *)rel->mgmtData)->bm, &page);
+	record->data = NULL;
+	return RC_OK;
+}
+
+
+/*
+SCANS
+*/
+
+/*
+ * Function: startScan
+ * ---------------------------
+ * This function is used to start scanning the table using scan management structure.
+ *
  *
  * rel: Management Structure for a Record Manager to handle one relation.
- * record: Management Structure for Record which has rid and data of a tuple.
+ * scan_mgmt: holds the scan management data
+ *
+ * returns : RC_OK if initializing scan is successful.
  *
- * returns : RC_OK if destroy getRecord is successful.
  */
 
-RC insertRecord (RM_TableData *rel, Record *record)
+RC startScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond)
 {
-	Record *r = (Record *)malloc(sizeof(Record));
-	RID rid;
-	rid.page = 1;
-	rid.slot = 0;
 
-	int recPage = rid.page;
-	for(recPage=1; recPage < totalPages; recPage++)
-	{
-		rid.page = rid.page + 1;
-		rid.slot = 0;
-	}
+	//Initialize the Scan Management Struct
+	RecordMgr_ScanMgmt *scan_mgmt = (RecordMgr_ScanMgmt*) malloc (sizeof(RecordMgr_ScanMgmt));
 
-	r = NULL;
-	free(r);
-	((Record_Manager *)rel->mgmtData)->freePages[0] = rid.page;
-	BM_PageHandle *page = MAKE_PAGE_HANDLE();
-	Schema *rel_schema = rel->schema;
-	record->id.page = ((Record_Manager *)rel->mgmtData)->freePages[0];
-	record->id.slot = 0;
+	//using Scan Handle Structure & init its attributes
+	scan->rel = rel;
+	((Record_Manager *)rel->mgmtData)->table.stats.scans += 1;
 
-	char * serializedRecord = serializeRecord(record, rel_schema);
+	scan_mgmt->currentPage = 1;
+	scan_mgmt->currentSlot = 0;
+	scan_mgmt->prefetchedUpTo = 0;
+	initAccessStrategy(&scan_mgmt->ring, SCAN_RING_SIZE);
+	scan_mgmt->condn = cond;
+	scan_mgmt->holding = 0;
+	scan_mgmt->columnFilter = canFilterBatch(cond, rel->schema);
 
-	pinPage(((Record_Manager *)rel->mgmtData)->bm, page, ((Record_Manager *)rel->mgmtData)->freePages[0]);
+	//update and store the managememt data
+	scan->mgmtData = scan_mgmt;
 
-	memset(page->data, '\0', strlen(page->data));
-	sprintf(page->data, "%s", serializedRecord);
-	updatePageInfo(rel,page);
-	free(page);
-	((Record_Manager *)rel->mgmtData)->freePages[0] += 1;
-	totalPages+=1;
 	return RC_OK;
 }
 
 /*
- * Function: deleteRecord
+ * Function: prefetchAhead
  * ---------------------------
- * This function is used to delete a record from the table.
+ * This function keeps the next SCAN_PREFETCH_DEPTH heap pages of a scan in flight,
+ * so that the scan finds them in the buffer pool instead of stalling on a read.
+ * The frames come from the scan's ring, not from the pool's working set.
  *
- * rel: Management Structure for a Record Manager to handle one relation.
- * id: rid to be deleted.
+ * scan_mgmt: holds the scan management data
+ * rel: the scanned table
+ *
+ * returns : void
  *
- * returns : RC_OK if delete record is successful.
- *					 RC_RM_NO_MORE_TUPLES if no tuples are available to delete.
  */
-RC deleteRecord (RM_TableData *rel, RID id)
+
+static void prefetchAhead(RecordMgr_ScanMgmt *scan_mgmt, RM_TableData *rel)
 {
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	int lastPage = scan_mgmt->currentPage + SCAN_PREFETCH_DEPTH;
+	int firstPage = scan_mgmt->prefetchedUpTo + 1;
 
-	char deleteFlag[3] = "DEL";
-	char *deletedflagstr = (char*)malloc(sizeof(char*));
-	if(id.page > 0 && id.page <=  totalPages)
+	if(lastPage >= rm_mgmt->table.numPages)
 	{
-		BM_PageHandle *page = MAKE_PAGE_HANDLE();
-		//Cannot delete already deleted record
-		if(strncmp(page->data, "DEL", 3) == 0)
-			return RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD;
-		pinPage(((Record_Manager *)rel->mgmtData)->bm, page, id.page);
-		strcpy(deletedflagstr, deleteFlag);
-		strcat(deletedflagstr, page->data);
-		page->pageNum = id.page;
-		memset(page->data, '\0', strlen(page->data));
-		sprintf(page->data, "%s", deletedflagstr);
-		printf("deleted record: %s\n", page->data);
-		updatePageInfo(rel,page);
-		page = NULL;
-		free(page);
-		return RC_OK;
+		lastPage = rm_mgmt->table.numPages - 1;
 	}
-	else
+	if(firstPage <= scan_mgmt->currentPage)
 	{
-		return RC_RM_NO_MORE_TUPLES;
+		firstPage = scan_mgmt->currentPage + 1;
+	}
+	if(firstPage <= lastPage)
+	{
+		prefetchPageRangeWithStrategy(rm_mgmt->bm, firstPage, lastPage - firstPage + 1, &scan_mgmt->ring);
+		scan_mgmt->prefetchedUpTo = lastPage;
 	}
-
-	return RC_OK;
 }
 
-
 /*
- * Function: updateRecord
+ * Function: enterPage
  * ---------------------------
- * This function is used to update a record in the table.
+ * This function pins the heap page under the scan cursor, unless the scan already holds it.
+ * Map pages hold no tuples and are stepped over without being pinned.
  *
- * rel: Management Structure for a Record Manager to handle one relation.
- * record: Management Structure for a Record to store rid and data of a tuple.
+ * scan_mgmt: holds the scan management data
+ * rel: the scanned table
+ *
+ * returns : RC_OK if the scan holds a heap page.
+ *			 RC_RM_NO_MORE_TUPLES past the last page.
+ *			 pinPage errors if the page cannot be pinned, the cursor stays on it then.
  *
- * returns : RC_OK if delete record is successful.
- *					 RC_RM_NO_MORE_TUPLES if no tuples are available to update.
  */
 
-RC updateRecord (RM_TableData *rel, Record *record)
+static RC enterPage (RecordMgr_ScanMgmt *scan_mgmt, RM_TableData *rel)
 {
-	printf("record to be updated: %s\n", record->data);
-	// Check boundary conditions for tuple availability
-	if(record->id.page <= 0 && record->id.page >  totalPages)
+	Record_Manager *rm_mgmt = (Record_Manager *)rel->mgmtData;
+	RC flag;
+
+	if(scan_mgmt->holding)
+	{
+		return RC_OK;
+	}
+	while(scan_mgmt->currentPage > 0 && scan_mgmt->currentPage < rm_mgmt->table.numPages
+			&& fsmPageOf(scan_mgmt->currentPage) == scan_mgmt->currentPage)
+	{
+		scan_mgmt->currentPage = scan_mgmt->currentPage + 1;
+	}
+	if(scan_mgmt->currentPage <= 0 || scan_mgmt->currentPage >= rm_mgmt->table.numPages)
 	{
 		return RC_RM_NO_MORE_TUPLES;
 	}
-	else
+	prefetchAhead(scan_mgmt, rel);
+	flag = pinPageWithStrategy(rm_mgmt->bm, &scan_mgmt->heldPage, scan_mgmt->currentPage, &scan_mgmt->ring);
+	if(flag != RC_OK)
 	{
-		BM_PageHandle *page = MAKE_PAGE_HANDLE();
-		int pageNum, slotNum;
-		pageNum = record->id.page;
-		slotNum = record->id.slot;
-		char *record_str = serializeRecord(record, rel->schema);
-		pinPage(((Record_Manager *)rel->mgmtData)->bm, page, record->id.page);
-		memset(page->data, '\0', strlen(page->data));
-		sprintf(page->data, "%s", record_str);
-		free(record_str);
-		updatePageInfo(rel,page);
-		free(page);
-		return RC_OK;
+		return flag;
 	}
-
+	scan_mgmt->holding = 1;
 	return RC_OK;
 }
 
 /*
- * Function: getRecord
+ * Function: leavePage
  * ---------------------------
- * This function is used to get a record from the table using rid.
- *
+ * This function unpins the held page and moves the scan cursor to the first slot of the next page.
  *
- * rel: Management Structure for a Record Manager to handle one relation.
- * rid: Record identifier.
- * record: Management Structure for a Record to store rid and data of a tuple.
+ * scan_mgmt: holds the scan management data
+ * bm: buffer pool of the scanned table
  *
- * returns : RC_OK if delete record is successful.
- *					 RC_RM_NO_MORE_TUPLES if no tuples are available to update.
+ * returns : void
  *
  */
 
-RC getRecord (RM_TableData *rel, RID id, Record *record)
+static void leavePage (RecordMgr_ScanMgmt *scan_mgmt, BM_BufferPool *bm)
 {
-
-	if(id.page <= 0 && id.page >  totalPages)
-	{
-		return RC_RM_NO_MORE_TUPLES;
-	}
-	else
-	{
-		BM_PageHandle *page = MAKE_PAGE_HANDLE();
-		pinPage(((Record_Manager *)rel->mgmtData)->bm, page, id.page);
-		char *record_data = (char*)malloc(sizeof(char) * strlen(page->data));
-		strcpy(record_data,page->data);
-		printf("%s record data: \n" ,record_data);
-
-
-		record->id = id;
-	  Record* deSerializedRecord = deserializeRecord(record_data,rel->schema);
-		unpinPage(((Record_Manager *)rel->mgmtData)->bm, page);
-		record->data = deSerializedRecord->data;
-		if(strncmp(record_data, "DEL", 3) == 0)
-			return RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD;
-		free(deSerializedRecord);
-		free(page);
-
-		return RC_OK;
-	}
-
-	return RC_OK;
+	unpinPage(bm, &scan_mgmt->heldPage);
+	scan_mgmt->holding = 0;
+	scan_mgmt->currentPage = scan_mgmt->currentPage + 1;
+	scan_mgmt->currentSlot = 0;
 }
 
-
-/*
-SCANS
-*/
-
 /*
- * Function: startScan
+ * Function: rewindScan
  * ---------------------------
- * This function is used to start scanning the table using scan management structure.
+ * This function moves the scan cursor back to the first heap page once a scan is exhausted.
  *
- *
- * rel: Management Structure for a Record Manager to handle one relation.
  * scan_mgmt: holds the scan management data
  *
- * returns : RC_OK if initializing scan is successful.
+ * returns : void
  *
  */
 
-RC startScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond)
+static void rewindScan (RecordMgr_ScanMgmt *scan_mgmt)
 {
+	scan_mgmt->currentPage = 1;
+	scan_mgmt->currentSlot = 0;
+	scan_mgmt->prefetchedUpTo = 0;
+}
 
-	//Initialize the Scan Management Struct
-	RecordMgr_ScanMgmt *scan_mgmt = (RecordMgr_ScanMgmt*) malloc (sizeof(RecordMgr_ScanMgmt));
+/*
+ * Function: advanceScan
+ * ---------------------------
+ * This function moves the scan cursor to the next tuple that satisfies the condition.
+ * Each heap page is pinned once when the cursor enters it and its slots are walked in the
+ * frame; the page is unpinned only when the cursor moves on to the next page.
+ *
+ * scan: The scan.
+ * tuple: Receives the rid and the address of the tuple in the held page.
+ *
+ * returns : RC_OK if a tuple was found, its page is held by the scan then.
+ *			 RC_RM_NO_MORE_TUPLES if no tuples are available to scan, the scan starts over then.
+ *			 pinPage errors if the next page cannot be pinned.
+ *
+ */
 
-	scan_mgmt->currentRecord = (Record*) malloc (sizeof(Record));
+static RC advanceScan (RM_ScanHandle *scan, Record *tuple)
+{
+	RecordMgr_ScanMgmt *scan_mgmt = (RecordMgr_ScanMgmt *)scan->mgmtData;
+	RM_Slot *slots;
+	Value *result;
+	bool match;
+	RC flag;
 
-	//using Scan Handle Structure & init its attributes
-	scan->rel = rel;
+	while((flag = enterPage(scan_mgmt, scan->rel)) == RC_OK)
+	{
+		//the slot directory is read on every step, the caller may delete or insert on the held page
+		slots = PAGE_SLOTS(scan_mgmt->heldPage.data);
+		while(scan_mgmt->currentSlot < PAGE_HEADER(scan_mgmt->heldPage.data)->numSlots)
+		{
+			tuple->id.page = scan_mgmt->currentPage;
+			tuple->id.slot = scan_mgmt->currentSlot;
+			scan_mgmt->currentSlot = scan_mgmt->currentSlot + 1;
 
-	scan_mgmt->currentPage = 1;
-	scan_mgmt->currentSlot = 0;
-	scan_mgmt->condn = cond;
+			//skip deleted records
+			if(slots[tuple->id.slot].length == 0)
+			{
+				continue;
+			}
+			tuple->data = scan_mgmt->heldPage.data + slots[tuple->id.slot].offset;
+			if(scan_mgmt->condn == NULL)
+			{
+				return RC_OK;
+			}
+			evalExpr (tuple, scan->rel->schema, scan_mgmt->condn, &result);
+			match = (result->dt == DT_BOOL && result->v.boolV);
+			freeVal(result);
+			if(match)
+			{
+				return RC_OK;
+			}
+		}
 
-	//update and store the managememt data
-	scan->mgmtData = scan_mgmt;
+		//past the last slot of the page, continue on the next page
+		leavePage(scan_mgmt, ((Record_Manager *)scan->rel->mgmtData)->bm);
+	}
 
-	return RC_OK;
+	tuple->data = NULL;
+	if(flag != RC_RM_NO_MORE_TUPLES)
+	{
+		//the cursor stays on the page, the next call tries it again
+		return flag;
+	}
+	rewindScan(scan_mgmt);
+
+	return RC_RM_NO_MORE_TUPLES;
 }
 
 /*
  * Function: next
  * ---------------------------
  * This function is used with the above function to perform the scan function
- *
+ * The attributes of the next record are copied into record->data, which the caller allocates.
  *
  * rid: Record identifier.
  * record: Management Structure for a Record to store rid and data of a tuple.
@@ -528,56 +2136,205 @@ RC startScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond)
  */
 RC next (RM_ScanHandle *scan, Record *record)
 {
-	Value *result;
-	RID rid;
-
-	rid.page = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage;
-	rid.slot = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentSlot;
+	Record tuple;
+	RC flag = advanceScan(scan, &tuple);
 
-	if(((RecordMgr_ScanMgmt *)scan->mgmtData)->condn == NULL)
+	if(flag == RC_OK)
 	{
-		while(rid.page > 0 && rid.page < totalPages)
-		{
-			getRecord (scan->rel, rid, ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentRecord);
+		record->id = tuple.id;
+		memcpy(record->data, tuple.data, PAGE_SLOTS(((RecordMgr_ScanMgmt *)scan->mgmtData)->heldPage.data)[tuple.id.slot].length);
+	}
+	return flag;
+}
+
+/*
+ * Function: nextInPlace
+ * ---------------------------
+ * This function is a next without copying: record->data is pointed at the tuple in the buffer pool
+ * frame. The scan holds the page until it moves on to the next one or closeScan, and the record
+ * stays valid until the following nextInPlace. Pass a record without its own data and do not
+ * modify the tuple through it.
+ *
+ * scan: The scan.
+ * record: Receives the rid and the address of the tuple.
+ *
+ * returns : RC_OK if scan operation is successful.
+ *			 RC_RM_NO_MORE_TUPLES if no tuples are available to scan.
+ */
+
+RC nextInPlace (RM_ScanHandle *scan, Record *record)
+{
+	return advanceScan(scan, record);
+}
 
-			record->data = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentRecord->data;
-			record->id = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentRecord->id;
-			((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage + 1;
+/*
+ * Function: copyColumns
+ * ---------------------------
+ * This function copies the attributes of the batch rows [first, numRows), which all lie on
+ * one page, into the columns of the batch, one attribute at a time.
+ *
+ * schema: schema of the table
+ * batch: the batch, ids holds the rids of the rows
+ * pageData: the page of the rows
+ * first: first row to copy
+ *
+ * returns : void
+ *
+ */
 
-			rid.page = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage;
-			rid.slot = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentSlot;
+static void copyColumns (Schema *schema, RecordBatch *batch, char *pageData, int first)
+{
+	RM_Slot *slots = PAGE_SLOTS(pageData);
+	char *column;
+	int offset = 0;
+	int attr, row, size;
 
-			return RC_OK;
+	for(attr = 0; attr < schema->numAttr; attr++)
+	{
+		column = batch->columns[attr];
+		size = attributeSize(schema, attr);
+		switch(schema->dataTypes[attr])
+		{
+		case DT_INT:
+			for(row = first; row < batch->numRows; row++)
+				memcpy(column + row * sizeof(int), pageData + slots[batch->ids[row].slot].offset + offset, sizeof(int));
+			break;
+		case DT_FLOAT:
+			for(row = first; row < batch->numRows; row++)
+				memcpy(column + row * sizeof(float), pageData + slots[batch->ids[row].slot].offset + offset, sizeof(float));
+			break;
+		case DT_BOOL:
+			for(row = first; row < batch->numRows; row++)
+				memcpy(column + row * sizeof(bool), pageData + slots[batch->ids[row].slot].offset + offset, sizeof(bool));
+			break;
+		case DT_STRING:
+			for(row = first; row < batch->numRows; row++)
+				memcpy(column + row * size, pageData + slots[batch->ids[row].slot].offset + offset, size);
+			break;
 		}
+		offset += size;
 	}
-	else
+}
+
+/*
+ * Function: selectRows
+ * ---------------------------
+ * This function adds the batch rows [first, numRows) that satisfy the scan condition to
+ * the selection vector. The condition is evaluated on the tuples in the held page.
+ *
+ * scan: The scan.
+ * batch: the batch
+ * first: first row to evaluate
+ *
+ * returns : void
+ *
+ */
+
+static void selectRows (RM_ScanHandle *scan, RecordBatch *batch, int first)
+{
+	RecordMgr_ScanMgmt *scan_mgmt = (RecordMgr_ScanMgmt *)scan->mgmtData;
+	RM_Slot *slots = PAGE_SLOTS(scan_mgmt->heldPage.data);
+	Record tuple;
+	Value *result;
+	int row;
+
+	for(row = first; row < batch->numRows; row++)
 	{
-		while(rid.page > 0 && rid.page < totalPages)
+		if(scan_mgmt->condn != NULL)
 		{
-			getRecord (scan->rel, rid, ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentRecord);
+			tuple.id = batch->ids[row];
+			tuple.data = scan_mgmt->heldPage.data + slots[tuple.id.slot].offset;
+			evalExpr (&tuple, scan->rel->schema, scan_mgmt->condn, &result);
+			if(result->dt != DT_BOOL || !result->v.boolV)
+			{
+				freeVal(result);
+				continue;
+			}
+			freeVal(result);
+		}
+		batch->sel[batch->numSelected++] = row;
+	}
+}
+
+/*
+ * Function: nextBatch
+ * ---------------------------
+ * This function reads the next rows of a scan into a batch, in column layout. The live tuples
+ * of the scanned pages are copied into the columns and the rows that satisfy the condition are
+ * listed in the selection vector; a batch is only returned if at least one row is selected.
+ * Conditions made of comparisons with constants are evaluated on the columns with filterBatch,
+ * others on each tuple with evalExpr.
+ * A scan may mix next and nextBatch calls.
+ *
+ * scan: The scan.
+ * out: The batch, see createRecordBatch.
+ * maxRows: Maximum number of rows to read, at most the capacity of the batch.
+ *
+ * returns : RC_OK if at least one row was selected.
+ *			 RC_RM_NO_MORE_TUPLES if no tuples are available to scan.
+ *			 pinPage errors if the next page cannot be pinned and no row was selected before it.
+ */
 
-			evalExpr (((RecordMgr_ScanMgmt *)scan->mgmtData)->currentRecord, scan->rel->schema, ((RecordMgr_ScanMgmt *)scan->mgmtData)->condn, &result);
+RC nextBatch (RM_ScanHandle *scan, RecordBatch *out, int maxRows)
+{
+	RecordMgr_ScanMgmt *scan_mgmt = (RecordMgr_ScanMgmt *)scan->mgmtData;
+	BM_BufferPool *bm = ((Record_Manager *)scan->rel->mgmtData)->bm;
+	RM_Slot *slots;
+	int numSlots, first;
+	RC flag = RC_OK;
 
-			if(result->dt == DT_BOOL && result->v.boolV)
+	if(maxRows <= 0 || maxRows > out->capacity)
+	{
+		maxRows = out->capacity;
+	}
+	do
+	{
+		out->numRows = 0;
+		out->numSelected = 0;
+		while(out->numRows < maxRows && (flag = enterPage(scan_mgmt, scan->rel)) == RC_OK)
+		{
+			slots = PAGE_SLOTS(scan_mgmt->heldPage.data);
+			numSlots = PAGE_HEADER(scan_mgmt->heldPage.data)->numSlots;
+			first = out->numRows;
+			for(; scan_mgmt->currentSlot < numSlots && out->numRows < maxRows; scan_mgmt->currentSlot++)
 			{
-				record->data = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentRecord->data;
-				record->id = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentRecord->id;
-				((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage + 1;
-
-				return RC_OK;
+				if(slots[scan_mgmt->currentSlot].length != 0)
+				{
+					out->ids[out->numRows].page = scan_mgmt->currentPage;
+					out->ids[out->numRows].slot = scan_mgmt->currentSlot;
+					out->numRows++;
+				}
 			}
-			else
+			copyColumns(scan->rel->schema, out, scan_mgmt->heldPage.data, first);
+			if(!scan_mgmt->columnFilter)
 			{
-				((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage + 1;
-				rid.page = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage;
-				rid.slot = ((RecordMgr_ScanMgmt *)scan->mgmtData)->currentSlot;
+				selectRows(scan, out, first);
 			}
+
+			//keep the page if the batch filled up before its last slot
+			if(scan_mgmt->currentSlot >= numSlots)
+			{
+				leavePage(scan_mgmt, bm);
+			}
+		}
+		if(scan_mgmt->columnFilter)
+		{
+			filterBatch(out, scan_mgmt->condn);
 		}
 	}
+	while(out->numSelected == 0 && flag == RC_OK);
 
-	((RecordMgr_ScanMgmt *)scan->mgmtData)->currentPage = 1;
-
-	return RC_RM_NO_MORE_TUPLES;
+	//rows read before a page failed to pin are returned, the next call retries that page
+	if(out->numSelected == 0 && flag != RC_RM_NO_MORE_TUPLES)
+	{
+		return flag;
+	}
+	if(out->numSelected == 0)
+	{
+		rewindScan(scan_mgmt);
+		return RC_RM_NO_MORE_TUPLES;
+	}
+	return RC_OK;
 }
 
 /*
@@ -594,13 +2351,14 @@ RC next (RM_ScanHandle *scan, Record *record)
  RC closeScan (RM_ScanHandle *scan)
 {
 	//Make all the allocations, NULL and free them
-
-	((RecordMgr_ScanMgmt *)scan->mgmtData)->currentRecord = NULL;
-	free(((RecordMgr_ScanMgmt *)scan->mgmtData)->currentRecord);
-
-	scan->mgmtData = NULL;
+	if(((RecordMgr_ScanMgmt *)scan->mgmtData)->holding)
+	{
+		unpinPage(((Record_Manager *)scan->rel->mgmtData)->bm, &((RecordMgr_ScanMgmt *)scan->mgmtData)->heldPage);
+	}
+	freeAccessStrategy(&((RecordMgr_ScanMgmt *)scan->mgmtData)->ring);
 
 	free(scan->mgmtData);
+	scan->mgmtData = NULL;
 
 	scan = NULL;
 	free(scan);
@@ -755,6 +2513,73 @@ RC freeRecord (Record *record)
 	return RC_OK;
 }
 
+/*
+ * Function: createRecordBatch
+ * ---------------------------
+ * This function allocates a batch for nextBatch with one column per attribute of the schema.
+ *
+ * batch: Receives the batch.
+ * schema: schema of the scanned table.
+ * capacity: Number of rows, RM_BATCH_DEFAULT_ROWS if not positive.
+ *
+ * returns : RC_OK
+ *
+ */
+
+RC createRecordBatch (RecordBatch **batch, Schema *schema, int capacity)
+{
+	RecordBatch *newBatch = (RecordBatch *) malloc(sizeof(RecordBatch));
+	int attr;
+
+	if(capacity <= 0)
+	{
+		capacity = RM_BATCH_DEFAULT_ROWS;
+	}
+	newBatch->schema = schema;
+	newBatch->capacity = capacity;
+	newBatch->numRows = 0;
+	newBatch->numSelected = 0;
+	newBatch->ids = (RID *) malloc(capacity * sizeof(RID));
+	newBatch->sel = (int *) malloc(capacity * sizeof(int));
+	newBatch->columns = (char **) malloc(schema->numAttr * sizeof(char *));
+	for(attr = 0; attr < schema->numAttr; attr++)
+	{
+		newBatch->columns[attr] = (char *) malloc((size_t) capacity * attributeSize(schema, attr) + RM_BATCH_COLUMN_PADDING);
+	}
+
+	*batch = newBatch;
+	return RC_OK;
+}
+
+/*
+ * Function: freeRecordBatch
+ * ---------------------------
+ * This function frees a batch and its columns.
+ *
+ * batch: The batch.
+ *
+ * returns : RC_OK
+ *
+ */
+
+RC freeRecordBatch (RecordBatch *batch)
+{
+	int attr;
+
+	if(batch != NULL)
+	{
+		for(attr = 0; attr < batch->schema->numAttr; attr++)
+		{
+			free(batch->columns[attr]);
+		}
+		free(batch->columns);
+		free(batch->sel);
+		free(batch->ids);
+		free(batch);
+	}
+	return RC_OK;
+}
+
 /*
  * Function: getAttr
  * ---------------------------
@@ -841,13 +2666,9 @@ RC setAttr (Record *record, Schema *schema, int attrNum, Value *value)
 
 	else if(schema->dataTypes[attrNum]==DT_STRING)
 	{
-		char *buf;
 		int len = schema->typeLength[attrNum];
-		buf = (char *) malloc(len);
-		buf = value->v.stringV;
-		//end the string with '\0'
-		buf[len] = '\0';
-		memcpy(attrData,buf,len);
+		//copy at most len bytes and pad shorter strings with '\0', the caller's string is not touched
+		strncpy(attrData,value->v.stringV,len);
 	}
 	else if(schema->dataTypes[attrNum]==DT_FLOAT)
 			memcpy(attrData,&(value->v.floatV), sizeof(float));
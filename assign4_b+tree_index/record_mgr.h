@@ -12,6 +12,46 @@ typedef struct RM_ScanHandle
 	void *mgmtData;
 } RM_ScanHandle;
 
+// Bookkeeping for bulk loads
+typedef struct RM_BulkLoader
+{
+	RM_TableData *rel;
+	void *mgmtData;
+} RM_BulkLoader;
+
+// Operation counters of a table, kept in its header page, see getTableStats
+typedef struct RM_TableStats
+{
+	long inserts;
+	long deletes;
+	long updates; // persisted with the next insert, delete or close
+	long scans; // persisted with the next insert, delete or close
+	long pagesAppended; // heap pages added to the file
+} RM_TableStats;
+
+// Rows of a scan in column layout, see nextBatch
+typedef struct RecordBatch
+{
+	Schema *schema;
+	int capacity; // rows each column has room for
+	int numRows; // rows read into the columns
+	RID *ids; // rid of each row
+	char **columns; // one array per attribute: an int, float or bool per row, or typeLength characters without terminator
+	int *sel; // selection vector, the rows that satisfy the scan condition in ascending order
+	int numSelected;
+} RecordBatch;
+
+#define RM_BATCH_DEFAULT_ROWS 2048
+// Bytes allocated after the last row of each column, vector loads may read a register past it
+#define RM_BATCH_COLUMN_PADDING 32
+
+// How modifications of a table reach the disk, see setWritePolicy
+typedef enum RM_WritePolicy
+{
+	RM_WRITE_FORCE = 0, // modified pages are written before the call returns
+	RM_WRITE_BACK = 1 // modified pages stay dirty in the pool, a redo log makes the changes durable
+} RM_WritePolicy;
+
 // table and manager
 extern RC initRecordManager (void *mgmtData);
 extern RC shutdownRecordManager ();
@@ -20,16 +60,32 @@ extern RC openTable (RM_TableData *rel, char *name);
 extern RC closeTable (RM_TableData *rel);
 extern RC deleteTable (char *name);
 extern int getNumTuples (RM_TableData *rel);
+extern RC getTableStats (RM_TableData *rel, RM_TableStats *stats);
+extern RC setWritePolicy (RM_TableData *rel, RM_WritePolicy policy);
+extern RC syncTableLog (RM_TableData *rel);
+extern RC checkpointTable (RM_TableData *rel);
 
 // handling records in a table
 extern RC insertRecord (RM_TableData *rel, Record *record);
 extern RC deleteRecord (RM_TableData *rel, RID id);
 extern RC updateRecord (RM_TableData *rel, Record *record);
 extern RC getRecord (RM_TableData *rel, RID id, Record *record);
+extern RC pinRecord (RM_TableData *rel, RID id, Record *record);
+extern RC releaseRecord (RM_TableData *rel, Record *record);
+
+// bulk loading
+extern RC insertRecords (RM_TableData *rel, Record **records, int n);
+extern RC startBulkLoad (RM_TableData *rel, RM_BulkLoader *loader);
+extern RC bulkLoadRecord (RM_BulkLoader *loader, Record *record);
+extern RC finishBulkLoad (RM_BulkLoader *loader);
+extern int buildHeapPage (Schema *schema, char *page, char *tuples, int n);
+extern RC bulkLoadPage (RM_BulkLoader *loader, char *page);
 
 // scans
 extern RC startScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond);
 extern RC next (RM_ScanHandle *scan, Record *record);
+extern RC nextInPlace (RM_ScanHandle *scan, Record *record);
+extern RC nextBatch (RM_ScanHandle *scan, RecordBatch *out, int maxRows);
 extern RC closeScan (RM_ScanHandle *scan);
 
 // dealing with schemas
@@ -42,5 +98,7 @@ extern RC createRecord (Record **record, Schema *schema);
 extern RC freeRecord (Record *record);
 extern RC getAttr (Record *record, Schema *schema, int attrNum, Value **value);
 extern RC setAttr (Record *record, Schema *schema, int attrNum, Value *value);
+extern RC createRecordBatch (RecordBatch **batch, Schema *schema, int capacity);
+extern RC freeRecordBatch (RecordBatch *batch);
 
 #endif // RECORD_MGR_H
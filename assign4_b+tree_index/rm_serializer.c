@@ -89,8 +89,9 @@ serializeTableContent(RM_TableData *rel)
   int i;
   VarString *result;
   RM_ScanHandle *sc = (RM_ScanHandle *) malloc(sizeof(RM_ScanHandle));
-  Record *r = (Record *) malloc(sizeof(Record));
+  Record *r;
   MAKE_VARSTRING(result);
+  createRecord(&r, rel->schema);
 
   for(i = 0; i < rel->schema->numAttr; i++)
     APPEND(result, "%s%s", (i != 0) ? ", " : "", rel->schema->attrNames[i]);
@@ -103,6 +104,7 @@ serializeTableContent(RM_TableData *rel)
     APPEND_STRING(result,"\n");
     }
   closeScan(sc);
+  freeRecord(r);
 
   RETURN_STRING(result);
 }
@@ -331,14 +333,11 @@ Schema *deserializeSchema(char *serializedSchemaData)
 	Schema *schema;
 	schema = (Schema*)malloc(sizeof(Schema));
 
-	char *splitStart, *splitEnd, *splitString;
-
-	splitStart = (char*)malloc(sizeof(char));
-	splitEnd  = (char*)malloc(sizeof(char));
-	splitString = (char*)malloc(sizeof(char));
+	char *splitStart, *splitEnd;
+	char *savePtr;
 
-	splitStart = strtok(serializedSchemaData,"<");
-	splitEnd = strtok(NULL,">");
+	splitStart = strtok_r(serializedSchemaData,"<",&savePtr);
+	splitEnd = strtok_r(NULL,">",&savePtr);
 
 	schemaNumAttr = strtol(splitEnd, &splitStart,10);
 
@@ -348,27 +347,25 @@ Schema *deserializeSchema(char *serializedSchemaData)
 	schema->dataTypes = (DataType*) malloc (sizeof (DataType) * schemaNumAttr);
 	schema->typeLength = (int*) malloc (sizeof(int) * schemaNumAttr);
 
-	splitEnd = strtok(NULL,"(");
+	splitEnd = strtok_r(NULL,"(",&savePtr);
 
   	lastAttr =  schemaNumAttr-1;
 
   	//enter dataTypes and their datalengths
   	for(i=0;i<schemaNumAttr;i++)
   	{
-  		splitEnd = strtok(NULL,": ");
+  		splitEnd = strtok_r(NULL,": ",&savePtr);
 
-  		schema->attrNames[i] = (char*)malloc(sizeof(char*));
-
-  		strcpy(schema->attrNames[i],splitEnd);
+  		schema->attrNames[i] = strdup(splitEnd);
 
   		if(i != lastAttr)
   		{
-  			splitEnd = strtok(NULL,", ");
+  			splitEnd = strtok_r(NULL,", ",&savePtr);
   		}
 
   		else
   		{
-  			splitEnd = strtok(NULL,") ");
+  			splitEnd = strtok_r(NULL,") ",&savePtr);
   		}
 
 
@@ -387,44 +384,33 @@ Schema *deserializeSchema(char *serializedSchemaData)
   			schema->dataTypes[i] = DT_BOOL;
   			schema->typeLength[i] = 0;
   		}
-  		else
+  		//STRING[SIZE]
+  		else if(strncmp(splitEnd,"STRING[",7)==0)
   		{
-  			strcpy(splitString, splitEnd);
-
-  			char *str;
-			str = (char*) malloc (sizeof(char));
-
-			sprintf(str,"%d",i);
-  			strcat(splitString,str);
-
-  			str = NULL;
-  			free(str);
+  			schema->dataTypes[i] = DT_STRING;
+  			schema->typeLength[i] = atoi(splitEnd + 7);
   		}
   	}
 
   	//to check ifkeys are present
-  	if((splitEnd = strtok(NULL,"("))!=NULL)
+  	if((splitEnd = strtok_r(NULL,"(",&savePtr))!=NULL)
   	{
 
   		char *splitKey;
 		char *keyAttr[schemaNumAttr];
   		int numOfKeys = 0;
 
-		splitEnd = strtok(NULL,")");
-		splitKey = (char*)malloc(sizeof(char));
-  		splitKey = strtok(splitEnd,", ");
+		splitEnd = strtok_r(NULL,")",&savePtr);
+  		splitKey = strtok_r(splitEnd,", ",&savePtr);
 
   		//Find out the number of Keys & store the attrValues for those Keys
   		while(splitKey!=NULL)
   		{
-  			keyAttr[numOfKeys] = (char*)malloc(sizeof(char*));
-  			strcpy(keyAttr[numOfKeys],splitKey);
+  			keyAttr[numOfKeys] = splitKey;
   			numOfKeys++;
-  			splitKey = strtok(NULL,", ");
+  			splitKey = strtok_r(NULL,", ",&savePtr);
   		}
 
-  		splitKey = NULL;
-  		free(splitKey);
 
   		//MARK all the key attrs as their INDEX values
   		schema->keyAttrs = (int*)malloc(sizeof(int)*numOfKeys);
@@ -444,32 +430,6 @@ Schema *deserializeSchema(char *serializedSchemaData)
   		}
   	}
 
-  	//for STRING[SIZE] allocate all the attributes
-
-  	if(strlen(splitString)!=0)
-  	{
-  		splitString = strtok(splitString,"[");
-  		if(strcmp(splitString,"STRING")==0)
-  		{
-  			int val, index;
-  			splitString = strtok(NULL,"]");
-  			val = atoi(splitString);
-  			splitString = strtok(NULL,"=");
-  			index = atoi(splitString);
-  			schema->dataTypes[index] = DT_STRING;
-
-  			schema->typeLength[index] = val;
-  		}
-  	}
-
-
-  	splitString = NULL;
-  	free(splitString);
-  	splitStart = NULL;
-  	free(splitStart);
-  	splitEnd = NULL;
-  	free(splitEnd);
-
   	return schema;
 }
 
@@ -500,20 +460,21 @@ Record* deserializeRecord(char *deserialize_record_str, Schema *schema)
 	record->data = (char*) malloc (sizeof(char*));
 
 	char *splitStart, *splitEnd;
+	char *savePtr;
 
-	splitStart = strtok(deserialize_record_str,"(");
+	splitStart = strtok_r(deserialize_record_str,"(",&savePtr);
 
 	for(i=0;i< schema->numAttr;i++)
 	{
-		splitEnd = strtok(NULL,":");
+		splitEnd = strtok_r(NULL,":",&savePtr);
 
 		if(i == lastAttr)
 		{
-			splitEnd = strtok(NULL,")");
+			splitEnd = strtok_r(NULL,")",&savePtr);
 		}
 		else
 		{
-			splitEnd = strtok(NULL,",");
+			splitEnd = strtok_r(NULL,",",&savePtr);
 		}
 
 		if(schema->dataTypes[i] == DT_INT)
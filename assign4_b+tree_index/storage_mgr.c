@@ -5,6 +5,11 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
+#include "unistd.h"
+#include "sys/uio.h"
+
+//Pages handed to the kernel per vectored read or write, well below the IOV_MAX of common systems.
+#define MAX_IO_VECTORS 64
 
 /*
 * Function: initStorageManger
@@ -111,7 +116,7 @@ RC closePageFile (SM_FileHandle *fHandle)
 /*
 * Function: destroyPageFile
 * ---------------------------
-* Destroys the file using the file pointer
+* Destroys the file using the file pointer, and the warm-up sidecar of the file if there is one
 *
 * fileName: Name of the file to be destroyed
 *
@@ -125,7 +130,14 @@ RC destroyPageFile (char *fileName)
 	if (fopen(fileName,"r")==NULL)
 		return RC_FILE_NOT_FOUND;
 	if (remove(fileName) == 0)
+	{
+		// The sidecar lists pages of the destroyed file, a new file of that name must not load it
+		char *sidecar = (char *) malloc(strlen(fileName) + strlen(WARMUP_SUFFIX) + 1);
+		sprintf(sidecar, "%s%s", fileName, WARMUP_SUFFIX);
+		remove(sidecar);
+		free(sidecar);
 		return RC_OK;
+	}
 }
 
 /*
@@ -157,6 +169,58 @@ RC readBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
 	}
 }
 
+/*
+* Function: readBlocks
+* ---------------------------
+* Reads numPages consecutive blocks starting at firstPage with vectored reads,
+* one system call for up to MAX_IO_VECTORS pages instead of one readBlock per page.
+*
+* firstPage: Page number of the first block
+* numPages: Number of consecutive blocks to read
+* fHandle: File Handle that contains information about the file
+* memPages: The numPages page handlers the data is read into, in page order
+*
+* return: RC_FILE_HANDLE_NOT_INIT if the file handle is not defined for the file
+* 		  RC_FILE_NOT_FOUND if the file pointer in the fhandle points to null indicating there is no such file
+*	      RC_READ_NON_EXISTING_PAGE if a page is beyond the end of the file or the read fails
+*		  RC_OK if the read successful
+*
+*/
+
+RC readBlocks (int firstPage, int numPages, SM_FileHandle *fHandle, SM_PageHandle *memPages)
+{
+	struct iovec iov[MAX_IO_VECTORS];
+	int done = 0, count, i;
+	ssize_t bytesRead;
+
+	if (fHandle == NULL) return RC_FILE_HANDLE_NOT_INIT;
+	if (fHandle->mgmtInfo == NULL) return RC_FILE_NOT_FOUND;
+	if (firstPage < 0 || numPages < 0 || firstPage + numPages > fHandle->totalNumPages) return RC_READ_NON_EXISTING_PAGE;
+
+	//pages appended through the stream must reach the file before reading around it
+	fflush(fHandle->mgmtInfo);
+	while(done < numPages)
+	{
+		count = (numPages - done < MAX_IO_VECTORS) ? numPages - done : MAX_IO_VECTORS;
+		for(i = 0; i < count; i++)
+		{
+			iov[i].iov_base = memPages[done + i];
+			iov[i].iov_len = PAGE_SIZE;
+		}
+		bytesRead = preadv(fileno(fHandle->mgmtInfo), iov, count, (off_t) (firstPage + done + 1) * PAGE_SIZE);
+		if(bytesRead != (ssize_t) count * PAGE_SIZE)
+		{
+			return RC_READ_NON_EXISTING_PAGE;
+		}
+		done += count;
+	}
+	if(numPages > 0)
+	{
+		fHandle->curPagePos = firstPage + numPages - 1;
+	}
+	return RC_OK;
+}
+
 /*
 * Function: getBlockPos
 * ---------------------------
@@ -312,6 +376,58 @@ RC writeBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
 
 }
 
+/*
+* Function: writeBlocks
+* ---------------------------
+* Writes numPages consecutive blocks starting at firstPage with vectored writes,
+* one system call for up to MAX_IO_VECTORS pages instead of one writeBlock per page.
+*
+* firstPage: Page number of the first block
+* numPages: Number of consecutive blocks to write
+* fHandle: File Handle that contains information about the file
+* memPages: The numPages page handlers whose data will be written, in page order
+*
+* return: RC_FILE_HANDLE_NOT_INIT if the file handle is not defined for the file
+* 		  RC_FILE_NOT_FOUND if the file pointer in the fhandle points to null indicating there is no such file
+*	      RC_WRITE_FAILED if a page is beyond the end of the file or the write fails
+*		  RC_OK if the write successful
+*
+*/
+
+RC writeBlocks (int firstPage, int numPages, SM_FileHandle *fHandle, SM_PageHandle *memPages)
+{
+	struct iovec iov[MAX_IO_VECTORS];
+	int done = 0, count, i;
+	ssize_t written;
+
+	if (fHandle == NULL) return RC_FILE_HANDLE_NOT_INIT;
+	if (fHandle->mgmtInfo == NULL) return RC_FILE_NOT_FOUND;
+	if (firstPage < 0 || numPages < 0 || firstPage + numPages > fHandle->totalNumPages) return RC_WRITE_FAILED;
+
+	//push out anything buffered in the stream before writing around it
+	fflush(fHandle->mgmtInfo);
+	while(done < numPages)
+	{
+		count = (numPages - done < MAX_IO_VECTORS) ? numPages - done : MAX_IO_VECTORS;
+		for(i = 0; i < count; i++)
+		{
+			iov[i].iov_base = memPages[done + i];
+			iov[i].iov_len = PAGE_SIZE;
+		}
+		written = pwritev(fileno(fHandle->mgmtInfo), iov, count, (off_t) (firstPage + done + 1) * PAGE_SIZE);
+		if(written != (ssize_t) count * PAGE_SIZE)
+		{
+			return RC_WRITE_FAILED;
+		}
+		done += count;
+	}
+	if(numPages > 0)
+	{
+		fHandle->curPagePos = firstPage + numPages - 1;
+	}
+	return RC_OK;
+}
+
 /*
 * Function: writeCurrentBlock
 * ---------------------------
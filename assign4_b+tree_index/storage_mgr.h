@@ -15,6 +15,9 @@ typedef struct SM_FileHandle {
 
 typedef char* SM_PageHandle;
 
+// Suffix of the warm-up sidecar the buffer manager keeps next to a page file, see setBufferPoolWarmup
+#define WARMUP_SUFFIX ".warm"
+
 /************************************************************
  *                    interface                             *
  ************************************************************/
@@ -27,6 +30,7 @@ extern RC destroyPageFile (char *fileName);
 
 /* reading blocks from disc */
 extern RC readBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage);
+extern RC readBlocks (int firstPage, int numPages, SM_FileHandle *fHandle, SM_PageHandle *memPages);
 extern int getBlockPos (SM_FileHandle *fHandle);
 extern RC readFirstBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
 extern RC readPreviousBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
@@ -36,6 +40,7 @@ extern RC readLastBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
 
 /* writing blocks to a page file */
 extern RC writeBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage);
+extern RC writeBlocks (int firstPage, int numPages, SM_FileHandle *fHandle, SM_PageHandle *memPages);
 extern RC writeCurrentBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
 extern RC appendEmptyBlock (SM_FileHandle *fHandle);
 extern RC ensureCapacity (int numberOfPages, SM_FileHandle *fHandle);
@@ -0,0 +1,592 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "unistd.h"
+#include "pthread.h"
+#include "sys/time.h"
+#include "storage_mgr.h"
+#include "record_mgr.h"
+#include "table_loader.h"
+
+/*Parallel table loader.
+	The calling thread reads the load file in chunks of whole rows. Worker threads convert the
+	rows of a chunk to the binary Record.data layout with setAttr and pack them into heap pages
+	with buildHeapPage. A single writer thread appends the pages of the chunks in file order
+	through a bulk load, so the table holds the rows in the order of the file.*/
+
+//Bytes of input a worker converts at a time, unless RM_LoadOptions.chunkSize is set.
+#define LOAD_CHUNK_SIZE (1 << 20)
+//Chunks read ahead of the writer per worker, bounds the memory of a load.
+#define LOAD_CHUNKS_PER_WORKER 2
+
+//A chunk of the load file and the pages built from it
+typedef struct LoadChunk
+{
+	long seq;
+	char *text; // whole rows of the file
+	int length;
+	char *pages; // built by a worker
+	int numPages;
+	long rows;
+	long rejected;
+	int done; // set when the worker finished the pages
+	struct LoadChunk *next;
+}
+LoadChunk;
+
+//State shared by the reader, the workers and the writer of a load
+typedef struct LoadState
+{
+	RM_TableData *rel;
+	RM_LoadOptions *options;
+	int recordSize;
+	pthread_mutex_t lock;
+	pthread_cond_t changed;
+	LoadChunk *first; // oldest chunk not yet written
+	LoadChunk *last;
+	LoadChunk *nextToConvert; // oldest chunk no worker took yet
+	int inFlight;
+	int readDone;
+	RC writeFlag;
+	RM_LoadStats stats;
+}
+LoadState;
+
+/*
+ * Function: initLoadOptions
+ * ---------------------------
+ * This function sets load options to the defaults: comma separated rows without a header,
+ * one worker per processor and chunks of LOAD_CHUNK_SIZE bytes.
+ *
+ * options: The options.
+ *
+ * returns : RC_OK
+ */
+
+RC initLoadOptions (RM_LoadOptions *options)
+{
+	options->format = RM_LOAD_DELIMITED;
+	options->delimiter = ',';
+	options->fieldWidths = NULL;
+	options->skipHeader = FALSE;
+	options->numWorkers = 0;
+	options->chunkSize = LOAD_CHUNK_SIZE;
+	return RC_OK;
+}
+
+/*
+ * Function: convertField
+ * ---------------------------
+ * This method converts the text of a field and stores it in a record with setAttr.
+ * Blanks around the text are ignored.
+ *
+ * schema: Schema of the table.
+ * attrNum: The attribute.
+ * text: The field, not terminated.
+ * len: Length of the field.
+ * record: The record.
+ *
+ * returns : 1 if the field converted, 0 if it is no value of the attribute's type.
+ */
+
+static int convertField(Schema *schema, int attrNum, char *text, int len, Record *record)
+{
+	char field[len + 1];
+	char *end;
+	Value value;
+
+	while(len > 0 && (*text == ' ' || *text == '\t'))
+	{
+		text++;
+		len--;
+	}
+	while(len > 0 && (text[len - 1] == ' ' || text[len - 1] == '\t'))
+	{
+		len--;
+	}
+	memcpy(field, text, len);
+	field[len] = '\0';
+	value.dt = schema->dataTypes[attrNum];
+
+	switch(schema->dataTypes[attrNum])
+	{
+	case DT_INT:
+		value.v.intV = strtol(field, &end, 10);
+		if(len == 0 || *end != '\0')
+		{
+			return 0;
+		}
+		break;
+	case DT_FLOAT:
+		value.v.floatV = strtof(field, &end);
+		if(len == 0 || *end != '\0')
+		{
+			return 0;
+		}
+		break;
+	case DT_BOOL:
+		if(strcmp(field, "true") == 0 || strcmp(field, "TRUE") == 0 || strcmp(field, "t") == 0 || strcmp(field, "1") == 0)
+		{
+			value.v.boolV = TRUE;
+		}
+		else if(strcmp(field, "false") == 0 || strcmp(field, "FALSE") == 0 || strcmp(field, "f") == 0 || strcmp(field, "0") == 0)
+		{
+			value.v.boolV = FALSE;
+		}
+		else
+		{
+			return 0;
+		}
+		break;
+	case DT_STRING:
+		//setAttr pads shorter strings, longer ones would be cut
+		if(len > schema->typeLength[attrNum])
+		{
+			return 0;
+		}
+		value.v.stringV = field;
+		break;
+	default:
+		return 0;
+	}
+	return setAttr(record, schema, attrNum, &value) == RC_OK;
+}
+
+/*
+ * Function: convertRow
+ * ---------------------------
+ * This method converts one text row into a record.
+ *
+ * state: The load.
+ * line: The row without its line end.
+ * len: Length of the row.
+ * record: The record, its data receives the row.
+ *
+ * returns : 1 if the row converted, 0 if it is rejected.
+ */
+
+static int convertRow(LoadState *state, char *line, int len, Record *record)
+{
+	Schema *schema = state->rel->schema;
+	RM_LoadOptions *options = state->options;
+	int i, start = 0, end;
+
+	for(i = 0; i < schema->numAttr; i++)
+	{
+		if(options->format == RM_LOAD_FIXED_WIDTH)
+		{
+			if(start >= len && i > 0)
+			{
+				return 0;
+			}
+			end = start + options->fieldWidths[i];
+			//editors drop the trailing blanks of the last field
+			if(end > len)
+			{
+				end = len;
+			}
+		}
+		else
+		{
+			if(start > len)
+			{
+				return 0;
+			}
+			for(end = start; end < len && line[end] != options->delimiter; end++);
+		}
+		if(!convertField(schema, i, line + start, end - start, record))
+		{
+			return 0;
+		}
+		start = (options->format == RM_LOAD_FIXED_WIDTH) ? end : end + 1;
+	}
+	//delimited rows must not have more fields than the schema
+	return options->format == RM_LOAD_FIXED_WIDTH || start > len;
+}
+
+/*
+ * Function: convertChunk
+ * ---------------------------
+ * This method converts the rows of a chunk and packs them into heap pages. Empty lines are skipped.
+ *
+ * state: The load.
+ * chunk: The chunk, its pages, rows and rejected counts are set.
+ *
+ * returns : void
+ */
+
+static void convertChunk(LoadState *state, LoadChunk *chunk)
+{
+	Schema *schema = state->rel->schema;
+	int maxRows = 1;
+	int i, lineStart, lineEnd, stored;
+	char *tuples;
+	Record record;
+
+	if(state->options->format == RM_LOAD_BINARY)
+	{
+		maxRows = chunk->length / state->recordSize;
+		tuples = chunk->text;
+		chunk->rows = maxRows;
+		chunk->rejected = (chunk->length % state->recordSize != 0) ? 1 : 0;
+	}
+	else
+	{
+		for(i = 0; i < chunk->length; i++)
+		{
+			maxRows += (chunk->text[i] == '\n');
+		}
+		tuples = (char *) calloc(maxRows, state->recordSize);
+		chunk->rows = 0;
+		chunk->rejected = 0;
+		lineStart = 0;
+		//the header is the first line of the first chunk
+		if(chunk->seq == 0 && state->options->skipHeader)
+		{
+			while(lineStart < chunk->length && chunk->text[lineStart++] != '\n');
+		}
+		while(lineStart < chunk->length)
+		{
+			for(lineEnd = lineStart; lineEnd < chunk->length && chunk->text[lineEnd] != '\n'; lineEnd++);
+			i = lineEnd;
+			if(i > lineStart && chunk->text[i - 1] == '\r')
+			{
+				i--;
+			}
+			if(i > lineStart)
+			{
+				record.data = tuples + chunk->rows * state->recordSize;
+				if(convertRow(state, chunk->text + lineStart, i - lineStart, &record))
+				{
+					chunk->rows += 1;
+				}
+				else
+				{
+					chunk->rejected += 1;
+				}
+			}
+			lineStart = lineEnd + 1;
+		}
+	}
+
+	chunk->pages = NULL;
+	chunk->numPages = 0;
+	for(i = 0; i < chunk->rows; i += stored)
+	{
+		if((chunk->numPages & (chunk->numPages - 1)) == 0)
+		{
+			//grow to the next power of two pages
+			chunk->pages = (char *) realloc(chunk->pages, (chunk->numPages == 0 ? 1 : 2 * chunk->numPages) * PAGE_SIZE);
+		}
+		stored = buildHeapPage(schema, chunk->pages + chunk->numPages * PAGE_SIZE,
+				tuples + i * state->recordSize, chunk->rows - i);
+		chunk->numPages += 1;
+	}
+	if(tuples != chunk->text)
+	{
+		free(tuples);
+	}
+	free(chunk->text);
+	chunk->text = NULL;
+}
+
+/*
+ * Function: loadWorker
+ * ---------------------------
+ * Thread converting chunks until the reader is done and no chunk is left.
+ *
+ * arg: The LoadState.
+ *
+ * returns : NULL
+ */
+
+static void *loadWorker(void *arg)
+{
+	LoadState *state = (LoadState *) arg;
+	LoadChunk *chunk;
+
+	pthread_mutex_lock(&state->lock);
+	while(1)
+	{
+		while(state->nextToConvert == NULL && !state->readDone)
+		{
+			pthread_cond_wait(&state->changed, &state->lock);
+		}
+		chunk = state->nextToConvert;
+		if(chunk == NULL)
+		{
+			break;
+		}
+		state->nextToConvert = chunk->next;
+		pthread_mutex_unlock(&state->lock);
+
+		convertChunk(state, chunk);
+
+		pthread_mutex_lock(&state->lock);
+		chunk->done = 1;
+		pthread_cond_broadcast(&state->changed);
+	}
+	pthread_mutex_unlock(&state->lock);
+	return NULL;
+}
+
+/*
+ * Function: loadWriter
+ * ---------------------------
+ * Thread appending the pages of converted chunks to the table in file order.
+ * After a failed write the remaining chunks are dropped, the load still runs to its end.
+ *
+ * arg: The LoadState.
+ *
+ * returns : NULL
+ */
+
+static void *loadWriter(void *arg)
+{
+	LoadState *state = (LoadState *) arg;
+	RM_BulkLoader loader;
+	LoadChunk *chunk;
+	RC flag, startFlag;
+	int i;
+
+	startFlag = startBulkLoad(state->rel, &loader);
+	pthread_mutex_lock(&state->lock);
+	if(state->writeFlag == RC_OK)
+	{
+		state->writeFlag = startFlag;
+	}
+	while(1)
+	{
+		while(!(state->first != NULL && state->first->done) && !(state->readDone && state->first == NULL))
+		{
+			pthread_cond_wait(&state->changed, &state->lock);
+		}
+		chunk = state->first;
+		if(chunk == NULL)
+		{
+			break;
+		}
+		pthread_mutex_unlock(&state->lock);
+
+		flag = state->writeFlag;
+		for(i = 0; i < chunk->numPages && flag == RC_OK; i++)
+		{
+			flag = bulkLoadPage(&loader, chunk->pages + i * PAGE_SIZE);
+		}
+
+		pthread_mutex_lock(&state->lock);
+		if(state->writeFlag == RC_OK)
+		{
+			state->writeFlag = flag;
+			state->stats.rows += chunk->rows;
+			state->stats.pages += chunk->numPages;
+		}
+		state->stats.rejectedRows += chunk->rejected;
+		state->first = chunk->next;
+		if(state->last == chunk)
+		{
+			state->last = NULL;
+		}
+		state->inFlight -= 1;
+		pthread_cond_broadcast(&state->changed);
+		free(chunk->pages);
+		free(chunk);
+	}
+	pthread_mutex_unlock(&state->lock);
+
+	flag = (startFlag == RC_OK) ? finishBulkLoad(&loader) : startFlag;
+	pthread_mutex_lock(&state->lock);
+	if(state->writeFlag == RC_OK)
+	{
+		state->writeFlag = flag;
+	}
+	pthread_mutex_unlock(&state->lock);
+	return NULL;
+}
+
+/*
+ * Function: queueChunk
+ * ---------------------------
+ * This method hands a chunk to the workers, waiting while the maximum number of chunks is in flight.
+ *
+ * state: The load.
+ * text: Whole rows, owned by the chunk.
+ * length: Bytes of text.
+ * seq: Position of the chunk in the file.
+ * maxInFlight: Most chunks read but not yet written.
+ *
+ * returns : void
+ */
+
+static void queueChunk(LoadState *state, char *text, int length, long seq, int maxInFlight)
+{
+	LoadChunk *chunk = (LoadChunk *) calloc(1, sizeof(LoadChunk));
+
+	chunk->seq = seq;
+	chunk->text = text;
+	chunk->length = length;
+
+	pthread_mutex_lock(&state->lock);
+	while(state->inFlight >= maxInFlight)
+	{
+		pthread_cond_wait(&state->changed, &state->lock);
+	}
+	if(state->last != NULL)
+	{
+		state->last->next = chunk;
+	}
+	else
+	{
+		state->first = chunk;
+	}
+	state->last = chunk;
+	if(state->nextToConvert == NULL)
+	{
+		state->nextToConvert = chunk;
+	}
+	state->inFlight += 1;
+	pthread_cond_broadcast(&state->changed);
+	pthread_mutex_unlock(&state->lock);
+}
+
+/*
+ * Function: loadTable
+ * ---------------------------
+ * This function appends the rows of a file to an open table. The rows are converted by
+ * worker threads and written by one writer through a bulk load, see startBulkLoad.
+ * Other inserts into the table must wait until the load returns.
+ *
+ * rel: Management Structure for a Record Manager to handle one relation.
+ * fileName: The load file.
+ * options: Format of the file and threads, NULL for the defaults of initLoadOptions.
+ * stats: Receives the counts and the load rate, may be NULL.
+ *
+ * returns : RC_OK if the file was loaded, rejected rows are counted and skipped.
+ *			 RC_FILE_NOT_FOUND if the file cannot be opened.
+ *			 RC_RM_INVALID_LOAD_OPTIONS if fixed width fields have no widths.
+ *			 bulk load errors if appending pages fails, rows before the failing chunk are loaded.
+ */
+
+RC loadTable (RM_TableData *rel, char *fileName, RM_LoadOptions *options, RM_LoadStats *stats)
+{
+	RM_LoadOptions defaults;
+	LoadState state;
+	pthread_t *workers;
+	pthread_t writer;
+	struct timeval startTime, endTime;
+	FILE *file;
+	char *carry = NULL, *text;
+	int carryLength = 0, length, usable, numWorkers, i;
+	size_t n;
+	long seq = 0;
+
+	if(options == NULL)
+	{
+		initLoadOptions(&defaults);
+		options = &defaults;
+	}
+	if(options->format == RM_LOAD_FIXED_WIDTH && options->fieldWidths == NULL)
+	{
+		return RC_RM_INVALID_LOAD_OPTIONS;
+	}
+	file = fopen(fileName, "rb");
+	if(file == NULL)
+	{
+		return RC_FILE_NOT_FOUND;
+	}
+	gettimeofday(&startTime, NULL);
+
+	memset(&state, 0, sizeof(LoadState));
+	state.rel = rel;
+	state.options = options;
+	state.recordSize = getRecordSize(rel->schema);
+	state.writeFlag = RC_OK;
+	pthread_mutex_init(&state.lock, NULL);
+	pthread_cond_init(&state.changed, NULL);
+
+	numWorkers = (options->numWorkers > 0) ? options->numWorkers : (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if(numWorkers < 1)
+	{
+		numWorkers = 1;
+	}
+	workers = (pthread_t *) malloc(numWorkers * sizeof(pthread_t));
+	for(i = 0; i < numWorkers; i++)
+	{
+		pthread_create(&workers[i], NULL, loadWorker, &state);
+	}
+	pthread_create(&writer, NULL, loadWriter, &state);
+
+	//read whole rows, the bytes behind the last row end of a chunk go to the next chunk
+	while(1)
+	{
+		int chunkSize = (options->chunkSize > 0) ? options->chunkSize : LOAD_CHUNK_SIZE;
+		if(options->format == RM_LOAD_BINARY && chunkSize < state.recordSize)
+		{
+			chunkSize = state.recordSize;
+		}
+		text = (char *) malloc(carryLength + chunkSize);
+		if(carryLength > 0)
+		{
+			memcpy(text, carry, carryLength);
+		}
+		free(carry);
+		carry = NULL;
+		n = fread(text + carryLength, 1, chunkSize, file);
+		length = carryLength + n;
+		if(length == 0)
+		{
+			free(text);
+			break;
+		}
+		if(n == 0)
+		{
+			//end of file, the rest is the last row, or a cut off binary row
+			usable = length;
+		}
+		else if(options->format == RM_LOAD_BINARY)
+		{
+			usable = length - length % state.recordSize;
+		}
+		else
+		{
+			for(usable = length; usable > 0 && text[usable - 1] != '\n'; usable--);
+		}
+		carryLength = length - usable;
+		if(carryLength > 0)
+		{
+			carry = (char *) malloc(carryLength);
+			memcpy(carry, text + usable, carryLength);
+		}
+		if(usable > 0)
+		{
+			queueChunk(&state, text, usable, seq++, numWorkers * LOAD_CHUNKS_PER_WORKER);
+		}
+		else
+		{
+			free(text);
+		}
+	}
+	fclose(file);
+
+	pthread_mutex_lock(&state.lock);
+	state.readDone = 1;
+	pthread_cond_broadcast(&state.changed);
+	pthread_mutex_unlock(&state.lock);
+	for(i = 0; i < numWorkers; i++)
+	{
+		pthread_join(workers[i], NULL);
+	}
+	pthread_join(writer, NULL);
+	free(workers);
+	pthread_mutex_destroy(&state.lock);
+	pthread_cond_destroy(&state.changed);
+
+	gettimeofday(&endTime, NULL);
+	state.stats.seconds = (endTime.tv_sec - startTime.tv_sec) + (endTime.tv_usec - startTime.tv_usec) / 1e6;
+	state.stats.rowsPerSecond = (state.stats.seconds > 0) ? state.stats.rows / state.stats.seconds : 0;
+	if(stats != NULL)
+	{
+		*stats = state.stats;
+	}
+	return state.writeFlag;
+}
@@ -0,0 +1,36 @@
+#ifndef TABLE_LOADER_H
+#define TABLE_LOADER_H
+
+#include "dberror.h"
+#include "tables.h"
+
+// Layout of the rows of a load file
+typedef enum RM_LoadFormat {
+	RM_LOAD_DELIMITED = 0, // one row per line, fields separated by a delimiter, no quoting
+	RM_LOAD_FIXED_WIDTH = 1, // one row per line, each field in a fixed number of characters
+	RM_LOAD_BINARY = 2 // rows in the binary Record.data layout, getRecordSize bytes each
+} RM_LoadFormat;
+
+// Options of loadTable, see initLoadOptions for the defaults
+typedef struct RM_LoadOptions {
+	RM_LoadFormat format;
+	char delimiter; // RM_LOAD_DELIMITED
+	int *fieldWidths; // RM_LOAD_FIXED_WIDTH, one width per attribute
+	bool skipHeader; // text formats, ignore the first line
+	int numWorkers; // threads converting rows, 0 for one per processor
+	int chunkSize; // bytes of input a worker converts at a time
+} RM_LoadOptions;
+
+// Outcome of loadTable
+typedef struct RM_LoadStats {
+	long rows; // rows appended to the table
+	long rejectedRows; // rows with a wrong field count or a value that does not convert
+	long pages; // heap pages appended
+	double seconds;
+	double rowsPerSecond;
+} RM_LoadStats;
+
+extern RC initLoadOptions (RM_LoadOptions *options);
+extern RC loadTable (RM_TableData *rel, char *fileName, RM_LoadOptions *options, RM_LoadStats *stats);
+
+#endif // TABLE_LOADER_H
@@ -84,6 +84,7 @@ extern Value *stringToValue (char *value);
 extern char *serializeTableInfo(RM_TableData *rel);
 extern char *serializeTableContent(RM_TableData *rel);
 extern char *serializeSchema(Schema *schema);
+extern Schema *deserializeSchema(char *serializedSchemaData);
 extern char *serializeRecord(Record *record, Schema *schema);
 extern char *serializeAttr(Record *record, Schema *schema, int attrNum);
 extern char *serializeValue(Value *val);
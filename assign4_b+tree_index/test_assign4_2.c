@@ -0,0 +1,1099 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "dberror.h"
+#include "storage_mgr.h"
+#include "buffer_mgr.h"
+#include "buffer_mgr_stat.h"
+#include "test_helper.h"
+
+#define TEST_PAGE_FILE "testbuffer.bin"
+#define OTHER_PAGE_FILE "testbuffer2.bin"
+#define TEST_TRACE_FILE "testbuffer.trace"
+
+// test methods
+static void testResize (void);
+static void testPinPages (void);
+static void testPinPagesConcurrentPin (void);
+static void testPinWaitTimeout (void);
+static void testLRUWriteBack (void);
+static void testPriorityClasses (void);
+static void testPrefetch (void);
+static void testStatsCounters (void);
+static void testGlobalPool (void);
+static void testWarmup (void);
+static void testBackgroundWriter (void);
+static void testRingStrategy (void);
+static void testSortedFlush (void);
+static void testBufferTrace (void);
+
+// helper methods
+static void createDummyPages (int num);
+static int fixCountOf (BM_BufferPool *bm, PageNumber pageNum);
+static void readPageFromDisk (PageNumber pageNum, char *data);
+static void *pinPagesThread (void *arg);
+static void *pinPageThread (void *arg);
+static void *pinLoopThread (void *arg);
+
+// test name
+char *testName;
+
+// main method
+int
+main (void)
+{
+  initStorageManager();
+  testName = "";
+
+  testResize();
+  testPinPages();
+  testPinPagesConcurrentPin();
+  testPinWaitTimeout();
+  testLRUWriteBack();
+  testPriorityClasses();
+  testPrefetch();
+  testStatsCounters();
+  testGlobalPool();
+  testWarmup();
+  testBackgroundWriter();
+  testRingStrategy();
+  testSortedFlush();
+  testBufferTrace();
+
+  return 0;
+}
+
+// ************************************************************
+void
+testResize (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *h0 = MAKE_PAGE_HANDLE();
+  BM_PageHandle *h1 = MAKE_PAGE_HANDLE();
+  char data[PAGE_SIZE];
+  testName = "resizing an LRU pool while pages are pinned";
+
+  createDummyPages(10);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 5, RS_LRU, NULL));
+
+  // three of five frames used, the hit on page 0 moves the LRU head onto its pinned frame
+  TEST_CHECK(pinPage(bm, h0, 0));
+  TEST_CHECK(pinPage(bm, h, 1));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h, 2));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h0, 0));
+
+  // shrinking releases the two empty frames, not the pinned one
+  TEST_CHECK(resizeBufferPool(bm, 3));
+  ASSERT_EQUALS_INT(3, bm->numPages, "pool has three frames");
+  ASSERT_EQUALS_INT(2, fixCountOf(bm, 0), "page 0 still pinned twice");
+  ASSERT_EQUALS_INT(0, fixCountOf(bm, 1), "page 1 still cached");
+  ASSERT_EQUALS_INT(0, fixCountOf(bm, 2), "page 2 still cached");
+  ASSERT_EQUALS_STRING("Page-0", h0->data, "pinned page keeps its content");
+
+  // not enough unpinned frames to go down to one
+  TEST_CHECK(pinPage(bm, h1, 1));
+  ASSERT_ERROR(resizeBufferPool(bm, 1), "cannot release pinned frames");
+  ASSERT_EQUALS_INT(3, bm->numPages, "failed shrink leaves the pool alone");
+  TEST_CHECK(unpinPage(bm, h1));
+
+  // a dirty page released by a shrink is written back
+  TEST_CHECK(pinPage(bm, h, 2));
+  sprintf(h->data, "%s", "Changed-2");
+  TEST_CHECK(markDirty(bm, h));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(resizeBufferPool(bm, 1));
+  ASSERT_EQUALS_INT(1, bm->numPages, "pool has one frame");
+  ASSERT_EQUALS_INT(2, fixCountOf(bm, 0), "only the pinned page is left");
+  readPageFromDisk(2, data);
+  ASSERT_EQUALS_STRING("Changed-2", data, "released dirty page was written back");
+
+  // growing adds empty frames which are filled before anything is evicted
+  TEST_CHECK(resizeBufferPool(bm, 4));
+  ASSERT_EQUALS_INT(4, bm->numPages, "pool has four frames");
+  TEST_CHECK(pinPage(bm, h, 5));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h, 6));
+  ASSERT_EQUALS_STRING("Page-6", h->data, "page read into a new frame");
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h, 7));
+  TEST_CHECK(unpinPage(bm, h));
+  ASSERT_EQUALS_INT(2, fixCountOf(bm, 0), "page 0 was not evicted");
+  ASSERT_EQUALS_INT(0, fixCountOf(bm, 5), "page 5 was not evicted");
+  ASSERT_EQUALS_INT(0, fixCountOf(bm, 7), "page 7 cached");
+
+  TEST_CHECK(unpinPage(bm, h0));
+  TEST_CHECK(unpinPage(bm, h0));
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h0);
+  free(h1);
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testPinPages (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle pages[3];
+  PageNumber firstPins[] = {3, 1, 3};
+  PageNumber tooMany[] = {5, 6, 7};
+  PageNumber secondPins[] = {6, 5};
+  PageNumber *frames;
+  char expected[PAGE_SIZE];
+  int i;
+  testName = "pinning several pages with one call";
+
+  createDummyPages(10);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 4, RS_FIFO, NULL));
+  TEST_CHECK(setPinWaitTimeout(bm, 0));
+
+  // a page listed twice is read once and pinned twice
+  TEST_CHECK(pinPages(bm, pages, firstPins, 3));
+  for(i = 0; i < 3; i++)
+    {
+      sprintf(expected, "%s-%i", "Page", firstPins[i]);
+      ASSERT_EQUALS_STRING(expected, pages[i].data, "pinned page has its content");
+    }
+  ASSERT_EQUALS_INT(2, getNumReadIO(bm), "each page read once");
+  ASSERT_EQUALS_INT(2, fixCountOf(bm, 3), "page 3 pinned twice");
+  ASSERT_EQUALS_INT(1, fixCountOf(bm, 1), "page 1 pinned once");
+
+  // two free frames for three pages, nothing stays pinned and the frames are empty again
+  ASSERT_ERROR(pinPages(bm, pages, tooMany, 3), "not enough frames");
+  ASSERT_EQUALS_INT(-1, fixCountOf(bm, 5), "page 5 not cached");
+  ASSERT_EQUALS_INT(-1, fixCountOf(bm, 6), "page 6 not cached");
+  frames = getFrameContents(bm);
+  ASSERT_EQUALS_INT(2, (frames[0] == NO_PAGE) + (frames[1] == NO_PAGE) + (frames[2] == NO_PAGE) + (frames[3] == NO_PAGE),
+		    "claimed frames were given back");
+
+  // the given back frames are used by the next call
+  TEST_CHECK(pinPages(bm, pages, secondPins, 2));
+  ASSERT_EQUALS_STRING("Page-6", pages[0].data, "page 6 read");
+  ASSERT_EQUALS_STRING("Page-5", pages[1].data, "page 5 read");
+  ASSERT_EQUALS_INT(4, getNumReadIO(bm), "missing pages read");
+  for(i = 0; i < 2; i++)
+    TEST_CHECK(unpinPage(bm, &pages[i]));
+
+  // unpinned frames are evicted for the next call
+  h->pageNum = 3;
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(unpinPage(bm, h));
+  h->pageNum = 1;
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPages(bm, pages, tooMany, 3));
+  for(i = 0; i < 3; i++)
+    {
+      sprintf(expected, "%s-%i", "Page", tooMany[i]);
+      ASSERT_EQUALS_STRING(expected, pages[i].data, "pinned page has its content");
+      TEST_CHECK(unpinPage(bm, &pages[i]));
+    }
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+// pool and pages of a pin running in its own thread
+typedef struct ThreadPin
+{
+  BM_BufferPool *bm;
+  BM_PageHandle pages[2];
+  PageNumber pageNums[2];
+  char seen[PAGE_SIZE]; // first page as it was when the pin returned
+  RC rc;
+} ThreadPin;
+
+void
+testPinPagesConcurrentPin (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h0 = MAKE_PAGE_HANDLE();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  ThreadPin batch, single;
+  pthread_t batchThread, singleThread;
+  testName = "a pin waits for the page pinPages is reading";
+
+  createDummyPages(10);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 2, RS_LRU, NULL));
+  TEST_CHECK(setPinWaitTimeout(bm, -1));
+  TEST_CHECK(pinPage(bm, h0, 0));
+  TEST_CHECK(pinPage(bm, h, 1));
+  TEST_CHECK(unpinPage(bm, h));
+
+  // page 5 takes the frame of page 1, page 6 waits for the pin of page 0 meanwhile
+  batch.bm = bm;
+  batch.pageNums[0] = 5;
+  batch.pageNums[1] = 6;
+  pthread_create(&batchThread, NULL, pinPagesThread, &batch);
+  usleep(100000);
+  ASSERT_EQUALS_INT(1, fixCountOf(bm, 5), "frame claimed for page 5");
+
+  // the frame still holds page 1, a pin of page 5 must not see it
+  single.bm = bm;
+  single.pageNums[0] = 5;
+  pthread_create(&singleThread, NULL, pinPageThread, &single);
+  usleep(100000);
+  TEST_CHECK(unpinPage(bm, h0));
+  pthread_join(batchThread, NULL);
+  pthread_join(singleThread, NULL);
+
+  TEST_CHECK(batch.rc);
+  TEST_CHECK(single.rc);
+  ASSERT_EQUALS_STRING("Page-5", batch.pages[0].data, "page 5 read by pinPages");
+  ASSERT_EQUALS_STRING("Page-6", batch.pages[1].data, "page 6 read by pinPages");
+  ASSERT_EQUALS_STRING("Page-5", single.seen, "concurrent pin sees page 5");
+  ASSERT_EQUALS_INT(2, fixCountOf(bm, 5), "page 5 pinned by both");
+  TEST_CHECK(unpinPage(bm, &batch.pages[0]));
+  TEST_CHECK(unpinPage(bm, &batch.pages[1]));
+  TEST_CHECK(unpinPage(bm, &single.pages[0]));
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h);
+  free(h0);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testPinWaitTimeout (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *h0 = MAKE_PAGE_HANDLE();
+  BM_PageHandle *h1 = MAKE_PAGE_HANDLE();
+  BM_PageHandle pages[1];
+  PageNumber missing[] = {2};
+  BM_PoolStats stats;
+  RC rc;
+  testName = "pins give up when every frame stays pinned";
+
+  createDummyPages(5);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 2, RS_LRU, NULL));
+  TEST_CHECK(setPinWaitTimeout(bm, 20));
+  TEST_CHECK(pinPage(bm, h0, 0));
+  TEST_CHECK(pinPage(bm, h1, 1));
+
+  // a miss waits for the timeout and leaves the pinned pages alone
+  rc = pinPage(bm, h, 2);
+  ASSERT_EQUALS_INT(RC_BM_PIN_TIMEOUT, rc, "pinPage times out");
+  rc = pinPages(bm, pages, missing, 1);
+  ASSERT_EQUALS_INT(RC_BM_PIN_TIMEOUT, rc, "pinPages times out");
+  ASSERT_EQUALS_INT(1, fixCountOf(bm, 0), "page 0 still pinned");
+  ASSERT_EQUALS_INT(1, fixCountOf(bm, 1), "page 1 still pinned");
+  ASSERT_EQUALS_INT(-1, fixCountOf(bm, 2), "page 2 not cached");
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(2, (int) stats.pinWaits, "both misses waited");
+  ASSERT_EQUALS_INT(2, (int) stats.pinWaitTimeouts, "both misses timed out");
+
+  // hits never wait
+  TEST_CHECK(pinPage(bm, h, 0));
+  TEST_CHECK(unpinPage(bm, h));
+
+  // an unpinned frame is evicted without waiting
+  TEST_CHECK(unpinPage(bm, h1));
+  TEST_CHECK(pinPage(bm, h, 2));
+  ASSERT_EQUALS_STRING("Page-2", h->data, "page 2 read into the freed frame");
+  ASSERT_EQUALS_INT(-1, fixCountOf(bm, 1), "page 1 evicted");
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(2, (int) stats.pinWaits, "no further waits");
+
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(unpinPage(bm, h0));
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h0);
+  free(h1);
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testLRUWriteBack (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  char data[PAGE_SIZE];
+  int i;
+  testName = "evicted dirty LRU pages are written back";
+
+  createDummyPages(10);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 2, RS_LRU, NULL));
+
+  // page 1 clean, pages 3 and 5 modified, page 4 pushes them out
+  TEST_CHECK(pinPage(bm, h, 1));
+  TEST_CHECK(unpinPage(bm, h));
+  for(i = 3; i <= 5; i += 2)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      sprintf(h->data, "%s-%i", "Dirty", i);
+      TEST_CHECK(markDirty(bm, h));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(pinPage(bm, h, 4));
+  TEST_CHECK(unpinPage(bm, h));
+  ASSERT_EQUALS_INT(-1, fixCountOf(bm, 3), "page 3 evicted");
+  readPageFromDisk(3, data);
+  ASSERT_EQUALS_STRING("Dirty-3", data, "evicted page written back");
+  TEST_CHECK(pinPage(bm, h, 3));
+  ASSERT_EQUALS_STRING("Dirty-3", h->data, "page read back with its change");
+  TEST_CHECK(unpinPage(bm, h));
+
+  // the frame replaced is the one written, no other dirty page is lost
+  TEST_CHECK(forceFlushPool(bm));
+  readPageFromDisk(5, data);
+  ASSERT_EQUALS_STRING("Dirty-5", data, "other modified page written");
+  ASSERT_EQUALS_INT(2, getNumWriteIO(bm), "each modified page written once");
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testPriorityClasses (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *h1 = MAKE_PAGE_HANDLE();
+  BM_PageHandle *h2 = MAKE_PAGE_HANDLE();
+  int i;
+  testName = "hot pages outlive normal and scan pages";
+
+  createDummyPages(12);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 3, RS_LRU, NULL));
+
+  // page 0 is the least recently used page, but hot, normal misses evict around it
+  TEST_CHECK(pinPageWithPriority(bm, h, 0, BM_PRIORITY_HOT));
+  TEST_CHECK(unpinPage(bm, h));
+  for(i = 1; i < 7; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+      ASSERT_EQUALS_INT(0, fixCountOf(bm, 0), "hot page 0 kept");
+    }
+
+  // a normal pin of a hot page does not demote it
+  TEST_CHECK(pinPage(bm, h, 0));
+  TEST_CHECK(unpinPage(bm, h));
+  for(i = 7; i < 9; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  ASSERT_EQUALS_INT(0, fixCountOf(bm, 0), "hot page 0 still kept");
+
+  // a page read once goes before a normal page used longer ago
+  TEST_CHECK(pinPageWithPriority(bm, h, 9, BM_PRIORITY_SCAN));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h, 10));
+  TEST_CHECK(unpinPage(bm, h));
+  ASSERT_EQUALS_INT(-1, fixCountOf(bm, 9), "scan page 9 evicted");
+  ASSERT_EQUALS_INT(0, fixCountOf(bm, 0), "hot page 0 kept");
+
+  // under real pressure the hot page is evicted too
+  TEST_CHECK(pinPage(bm, h1, 10));
+  TEST_CHECK(pinPage(bm, h2, 11));
+  TEST_CHECK(pinPage(bm, h, 1));
+  ASSERT_EQUALS_INT(-1, fixCountOf(bm, 0), "hot page 0 evicted");
+  ASSERT_EQUALS_STRING("Page-1", h->data, "page 1 read into its frame");
+
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(unpinPage(bm, h1));
+  TEST_CHECK(unpinPage(bm, h2));
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h1);
+  free(h2);
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testPrefetch (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *h1 = MAKE_PAGE_HANDLE();
+  PageNumber wanted[] = {5, 6, 7, 1};
+  BM_PoolStats stats;
+  SM_FileHandle fh;
+  char data[PAGE_SIZE];
+  testName = "prefetching pages into free frames";
+
+  createDummyPages(10);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 4, RS_LRU, NULL));
+
+  // a dirty page and a pinned page, two frames left
+  TEST_CHECK(pinPage(bm, h, 0));
+  sprintf(h->data, "%s", "Changed-0");
+  TEST_CHECK(markDirty(bm, h));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h1, 1));
+
+  // pages 5 and 6 fill the empty frames, page 7 finds no clean frame, page 1 is cached already
+  TEST_CHECK(prefetchPages(bm, wanted, 4));
+  TEST_CHECK(pinPage(bm, h, 5));
+  ASSERT_EQUALS_STRING("Page-5", h->data, "prefetched page 5 has its content");
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h, 6));
+  ASSERT_EQUALS_STRING("Page-6", h->data, "prefetched page 6 has its content");
+  TEST_CHECK(unpinPage(bm, h));
+  ASSERT_EQUALS_INT(4, getNumReadIO(bm), "pins of prefetched pages do not read");
+  ASSERT_EQUALS_INT(0, fixCountOf(bm, 0), "dirty page 0 was not replaced");
+  ASSERT_EQUALS_INT(-1, fixCountOf(bm, 7), "page 7 not prefetched");
+  readPageFromDisk(0, data);
+  ASSERT_EQUALS_STRING("Page-0", data, "prefetching does not write dirty pages");
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(2, (int) stats.prefetchReads, "two pages prefetched");
+
+  // a range reaching past the end of the file stops at the last page and reuses clean frames
+  TEST_CHECK(prefetchPageRange(bm, 8, 5));
+  TEST_CHECK(pinPage(bm, h, 9));
+  ASSERT_EQUALS_STRING("Page-9", h->data, "prefetched page 9 has its content");
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h, 8));
+  ASSERT_EQUALS_STRING("Page-8", h->data, "prefetched page 8 has its content");
+  TEST_CHECK(unpinPage(bm, h));
+  ASSERT_EQUALS_INT(6, getNumReadIO(bm), "pins of prefetched pages do not read");
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(4, (int) stats.prefetchReads, "four pages prefetched");
+  TEST_CHECK(openPageFile(TEST_PAGE_FILE, &fh));
+  ASSERT_EQUALS_INT(10, fh.totalNumPages, "file not extended");
+  TEST_CHECK(closePageFile(&fh));
+
+  TEST_CHECK(unpinPage(bm, h1));
+  TEST_CHECK(shutdownBufferPool(bm));
+  readPageFromDisk(0, data);
+  ASSERT_EQUALS_STRING("Changed-0", data, "dirty page written at shutdown");
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h1);
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testStatsCounters (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PoolStats stats, totals;
+  ThreadPin loops[4];
+  pthread_t threads[4];
+  long hits = 0, misses = 0;
+  int i;
+  testName = "pool and strategy event counters";
+
+  createDummyPages(10);
+  TEST_CHECK(resetStrategyStats(RS_FIFO));
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 3, RS_FIFO, NULL));
+
+  // a hit, then pages 3 and 4 replace the clean page 0 and the modified page 1
+  for(i = 0; i < 3; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      if (i == 1)
+	TEST_CHECK(markDirty(bm, h));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(pinPage(bm, h, 2));
+  TEST_CHECK(unpinPage(bm, h));
+  for(i = 3; i < 5; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(markDirty(bm, h));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(pinPage(bm, h, 4));
+  TEST_CHECK(forcePage(bm, h));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(forceFlushPool(bm));
+
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(2, (int) stats.hits, "pins of resident pages");
+  ASSERT_EQUALS_INT(5, (int) stats.misses, "pins which read the page");
+  ASSERT_EQUALS_INT(1, (int) stats.cleanEvictions, "clean victim dropped");
+  ASSERT_EQUALS_INT(1, (int) stats.dirtyEvictions, "modified victim written");
+  ASSERT_EQUALS_INT(1, (int) stats.forcedWrites, "forcePage write");
+  ASSERT_EQUALS_INT(1, (int) stats.flushWrites, "forceFlushPool write");
+  TEST_CHECK(getStrategyStats(RS_FIFO, &totals));
+  ASSERT_EQUALS_INT((int) stats.hits, (int) totals.hits, "strategy hits of the only pool");
+  ASSERT_EQUALS_INT((int) stats.misses, (int) totals.misses, "strategy misses of the only pool");
+  TEST_CHECK(resetPoolStats(bm));
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(0, (int) stats.misses, "pool counters reset");
+  TEST_CHECK(getStrategyStats(RS_FIFO, &totals));
+  ASSERT_EQUALS_INT(5, (int) totals.misses, "strategy totals kept");
+  TEST_CHECK(shutdownBufferPool(bm));
+
+  // pools pinning in parallel add up to the strategy totals, shut down pools included
+  TEST_CHECK(resetStrategyStats(RS_FIFO));
+  for(i = 0; i < 4; i++)
+    pthread_create(&threads[i], NULL, pinLoopThread, &loops[i]);
+  for(i = 0; i < 4; i++)
+    {
+      pthread_join(threads[i], NULL);
+      TEST_CHECK(loops[i].rc);
+      hits += loops[i].pageNums[0];
+      misses += loops[i].pageNums[1];
+    }
+  TEST_CHECK(getStrategyStats(RS_FIFO, &totals));
+  ASSERT_EQUALS_INT(4 * 2000, (int) (totals.hits + totals.misses), "every pin counted once");
+  ASSERT_EQUALS_INT((int) hits, (int) totals.hits, "hits of all pools");
+  ASSERT_EQUALS_INT((int) misses, (int) totals.misses, "misses of all pools");
+  ASSERT_ERROR(getStrategyStats(RS_LRU_K + 1, &totals), "unknown strategy");
+
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testGlobalPool (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_BufferPool *other = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *o = MAKE_PAGE_HANDLE();
+  SM_FileHandle fh;
+  char data[PAGE_SIZE];
+  RC rc;
+  int i;
+  testName = "two files sharing the global pool";
+
+  createDummyPages(10);
+  TEST_CHECK(createPageFile(OTHER_PAGE_FILE));
+  TEST_CHECK(openPageFile(OTHER_PAGE_FILE, &fh));
+  TEST_CHECK(ensureCapacity(10, &fh));
+  TEST_CHECK(closePageFile(&fh));
+
+  rc = initSharedBufferPool(bm, TEST_PAGE_FILE);
+  ASSERT_EQUALS_INT(RC_BM_GLOBAL_POOL_NOT_INIT, rc, "no global pool yet");
+  TEST_CHECK(initGlobalBufferPool(3, RS_FIFO, NULL));
+  ASSERT_ERROR(initGlobalBufferPool(3, RS_FIFO, NULL), "only one global pool");
+  TEST_CHECK(initSharedBufferPool(bm, TEST_PAGE_FILE));
+  TEST_CHECK(initSharedBufferPool(other, OTHER_PAGE_FILE));
+  ASSERT_EQUALS_INT(3, bm->numPages, "handle sees the global frames");
+
+  // page 0 of both files in one pool, the frames are told apart by file
+  TEST_CHECK(pinPage(bm, h, 0));
+  TEST_CHECK(pinPage(other, o, 0));
+  ASSERT_EQUALS_STRING("Page-0", h->data, "page of the first file");
+  ASSERT_TRUE(h->data != o->data, "same page number, different frames");
+  sprintf(o->data, "%s-%i", "Other", 0);
+  TEST_CHECK(markDirty(other, o));
+  TEST_CHECK(unpinPage(other, o));
+
+  // pages of the first file push the modified page of the other file out, it is written to its own file
+  for(i = 1; i < 4; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(openPageFile(OTHER_PAGE_FILE, &fh));
+  TEST_CHECK(readBlock(0, &fh, data));
+  TEST_CHECK(closePageFile(&fh));
+  ASSERT_EQUALS_STRING("Other-0", data, "evicted page written to its file");
+  readPageFromDisk(0, data);
+  ASSERT_EQUALS_STRING("Page-0", data, "first file untouched");
+
+  // nothing is shut down while a page is pinned
+  TEST_CHECK(pinPage(other, o, 5));
+  sprintf(o->data, "%s-%i", "Other", 5);
+  TEST_CHECK(markDirty(other, o));
+  rc = shutdownBufferPool(other);
+  ASSERT_EQUALS_INT(RC_BM_FRAMES_PINNED, rc, "file with a pinned page stays attached");
+  rc = shutdownGlobalBufferPool();
+  ASSERT_EQUALS_INT(RC_BM_FRAMES_PINNED, rc, "global pool with a pinned page stays up");
+  TEST_CHECK(unpinPage(other, o));
+  h->pageNum = 0;
+  TEST_CHECK(unpinPage(bm, h));
+
+  // shutting the global pool down writes the pages of every attached file
+  TEST_CHECK(shutdownGlobalBufferPool());
+  TEST_CHECK(openPageFile(OTHER_PAGE_FILE, &fh));
+  TEST_CHECK(readBlock(5, &fh, data));
+  TEST_CHECK(closePageFile(&fh));
+  ASSERT_EQUALS_STRING("Other-5", data, "dirty page written at shutdown");
+  rc = shutdownGlobalBufferPool();
+  ASSERT_EQUALS_INT(RC_BM_GLOBAL_POOL_NOT_INIT, rc, "global pool gone");
+
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+  TEST_CHECK(destroyPageFile(OTHER_PAGE_FILE));
+
+  free(o);
+  free(h);
+  free(other);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testWarmup (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  PageNumber resident[] = {7, 2, 5};
+  BM_PoolStats stats;
+  char *sidecar = TEST_PAGE_FILE WARMUP_SUFFIX;
+  int i;
+  testName = "a restarted pool is warmed up with its previous pages";
+
+  createDummyPages(10);
+  TEST_CHECK(setBufferPoolWarmup(true));
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 4, RS_FIFO, NULL));
+  for(i = 0; i < 3; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, resident[i]));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(shutdownBufferPool(bm));
+  ASSERT_TRUE(access(sidecar, F_OK) == 0, "resident pages dumped at shutdown");
+
+  // the restarted pool prefetches the three pages, pins of them read nothing
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 4, RS_FIFO, NULL));
+  ASSERT_TRUE(access(sidecar, F_OK) != 0, "sidecar removed once loaded");
+  for(i = 0; i < 3; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, resident[i]));
+      ASSERT_EQUALS_INT(resident[i], h->pageNum, "warmed up page pinned");
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(0, (int) stats.misses, "warmed up pages are hits");
+  ASSERT_EQUALS_INT(3, (int) stats.prefetchReads, "pages read by the prefetch worker");
+
+  // destroying the page file takes the sidecar written at shutdown with it
+  TEST_CHECK(shutdownBufferPool(bm));
+  ASSERT_TRUE(access(sidecar, F_OK) == 0, "resident pages dumped again");
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+  ASSERT_TRUE(access(sidecar, F_OK) != 0, "sidecar destroyed with the page file");
+
+  // a new file of that name starts cold
+  createDummyPages(10);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 4, RS_FIFO, NULL));
+  TEST_CHECK(pinPage(bm, h, 7));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(1, (int) stats.misses, "no stale pages loaded");
+  TEST_CHECK(setBufferPoolWarmup(false));
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testBackgroundWriter (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *h3 = MAKE_PAGE_HANDLE();
+  BM_PoolStats stats;
+  char data[PAGE_SIZE], expected[PAGE_SIZE];
+  RC rc;
+  int i;
+  testName = "background writer cleans frames ahead of eviction";
+
+  createDummyPages(10);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 4, RS_FIFO, NULL));
+  rc = startBackgroundWriter(bm, 0, 1, 1);
+  ASSERT_EQUALS_INT(RC_BM_INVALID_WRITER_CONFIG, rc, "interval must be positive");
+
+  // four modified pages fill the pool, page 3 stays pinned
+  for(i = 0; i < 4; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      sprintf(h->data, "%s-%i", "Dirty", i);
+      TEST_CHECK(markDirty(bm, h));
+      if (i < 3)
+	TEST_CHECK(unpinPage(bm, h));
+    }
+  *h3 = *h;
+  TEST_CHECK(startBackgroundWriter(bm, 10, 4, 4));
+  rc = startBackgroundWriter(bm, 10, 4, 4);
+  ASSERT_EQUALS_INT(RC_BM_WRITER_ALREADY_RUNNING, rc, "one writer per pool");
+  usleep(200000);
+
+  // the unpinned pages are on disk, the pinned one is left alone
+  for(i = 0; i < 3; i++)
+    {
+      sprintf(expected, "%s-%i", "Dirty", i);
+      readPageFromDisk(i, data);
+      ASSERT_EQUALS_STRING(expected, data, "dirty page written by the writer");
+    }
+  readPageFromDisk(3, data);
+  ASSERT_EQUALS_STRING("Page-3", data, "pinned page not written");
+  ASSERT_EQUALS_INT(1, getNumDirtyPages(bm), "only the pinned page still dirty");
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(3, (int) stats.writerWrites, "writes counted for the writer");
+
+  // a miss now replaces a clean frame without writing
+  TEST_CHECK(pinPage(bm, h, 5));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(1, (int) stats.cleanEvictions, "victim was clean");
+  ASSERT_EQUALS_INT(0, (int) stats.dirtyEvictions, "no write on the miss");
+
+  TEST_CHECK(stopBackgroundWriter(bm));
+  TEST_CHECK(stopBackgroundWriter(bm));
+  TEST_CHECK(unpinPage(bm, h3));
+  TEST_CHECK(shutdownBufferPool(bm));
+  readPageFromDisk(3, data);
+  ASSERT_EQUALS_STRING("Dirty-3", data, "pinned page written at shutdown");
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h3);
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testRingStrategy (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *held = MAKE_PAGE_HANDLE();
+  BM_AccessStrategy ring;
+  BM_PoolStats stats;
+  char data[PAGE_SIZE];
+  RC rc;
+  int i;
+  testName = "ring access strategy recycles its own frames";
+
+  rc = initAccessStrategy(&ring, 0);
+  ASSERT_EQUALS_INT(RC_BM_INVALID_POOL_SIZE, rc, "ring size must be positive");
+
+  createDummyPages(20);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 6, RS_LRU, NULL));
+  TEST_CHECK(initAccessStrategy(&ring, 2));
+
+  // pages used by other callers
+  for(i = 0; i < 3; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+
+  // a scan over pages 3 to 9, the first two fill the ring
+  for(i = 3; i < 10; i++)
+    {
+      TEST_CHECK(pinPageWithStrategy(bm, h, i, &ring));
+      if (i == 3)
+	{
+	  sprintf(h->data, "%s-%i", "Ring", i);
+	  TEST_CHECK(markDirty(bm, h));
+	}
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(5, (int) stats.ringReuses, "later misses reuse ring frames");
+  ASSERT_EQUALS_INT(1, (int) stats.dirtyEvictions, "dirty ring frame written back");
+  readPageFromDisk(3, data);
+  ASSERT_EQUALS_STRING("Ring-3", data, "recycled page is on disk");
+
+  // a pinned ring frame is not reused, the page goes through LRU instead
+  TEST_CHECK(pinPageWithStrategy(bm, held, 10, &ring));
+  TEST_CHECK(pinPageWithStrategy(bm, h, 11, &ring));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPageWithStrategy(bm, h, 12, &ring));
+  ASSERT_EQUALS_STRING("Page-12", h->data, "page read through the pool policy");
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(7, (int) stats.ringReuses, "pinned slot skipped");
+  TEST_CHECK(unpinPage(bm, held));
+
+  // the scan left the other pages in the pool
+  TEST_CHECK(resetPoolStats(bm));
+  for(i = 0; i < 3; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(3, (int) stats.hits, "pages outside the ring still cached");
+  ASSERT_EQUALS_INT(0, (int) stats.misses, "no page outside the ring evicted");
+
+  TEST_CHECK(freeAccessStrategy(&ring));
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(held);
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testSortedFlush (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *held = MAKE_PAGE_HANDLE();
+  BM_PoolStats stats;
+  // two runs (2-3, 6-7) and single pages, pinned out of order
+  PageNumber dirtyPages[] = { 7, 2, 9, 6, 0, 3 };
+  char data[PAGE_SIZE], expected[PAGE_SIZE];
+  int i;
+  testName = "forceFlushPool writes dirty pages in page order and coalesces runs";
+
+  createDummyPages(12);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 8, RS_FIFO, NULL));
+  for(i = 0; i < 6; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, dirtyPages[i]));
+      sprintf(h->data, "%s-%i", "Dirty", dirtyPages[i]);
+      TEST_CHECK(markDirty(bm, h));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  // a clean page and a pinned dirty page between the dirty ones
+  TEST_CHECK(pinPage(bm, h, 8));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, held, 4));
+  sprintf(held->data, "%s-%i", "Dirty", 4);
+  TEST_CHECK(markDirty(bm, held));
+
+  TEST_CHECK(forceFlushPool(bm));
+  for(i = 0; i < 10; i++)
+    {
+      if (i == 4 || i == 8 || i == 1 || i == 5)
+	sprintf(expected, "%s-%i", "Page", i);
+      else
+	sprintf(expected, "%s-%i", "Dirty", i);
+      readPageFromDisk(i, data);
+      ASSERT_EQUALS_STRING(expected, data, "page content on disk after flush");
+    }
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_EQUALS_INT(6, (int) stats.flushWrites, "one flush write per page");
+  ASSERT_EQUALS_INT(6, getNumWriteIO(bm), "write IO counts pages, not runs");
+  ASSERT_EQUALS_INT(1, getNumDirtyPages(bm), "pinned page still dirty");
+
+  // nothing left to write until the pin is gone
+  TEST_CHECK(forceFlushPool(bm));
+  ASSERT_EQUALS_INT(6, getNumWriteIO(bm), "written pages are clean");
+  TEST_CHECK(unpinPage(bm, held));
+  TEST_CHECK(forceFlushPool(bm));
+  readPageFromDisk(4, data);
+  ASSERT_EQUALS_STRING("Dirty-4", data, "released page written");
+  ASSERT_EQUALS_INT(7, getNumWriteIO(bm), "one more write");
+  ASSERT_EQUALS_INT(0, getNumDirtyPages(bm), "no dirty page left");
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(held);
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testBufferTrace (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle pages[2];
+  PageNumber pageNums[] = { 4, 6 };
+  BM_TraceHeader header;
+  BM_TraceRecord record;
+  // expected records, page and op
+  int expected[][2] = {
+    { 1, BM_TRACE_PIN }, { 1, BM_TRACE_DIRTY }, { 1, BM_TRACE_UNPIN },
+    { 4, BM_TRACE_PIN }, { 6, BM_TRACE_PIN },
+    { 4, BM_TRACE_UNPIN }, { 6, BM_TRACE_UNPIN }, { 1, BM_TRACE_PIN }
+  };
+  FILE *file;
+  RC rc;
+  int i;
+  testName = "buffer trace records pins, unpins and dirty pages";
+
+  createDummyPages(10);
+  TEST_CHECK(initBufferPool(bm, TEST_PAGE_FILE, 3, RS_LRU, NULL));
+  // calls before the trace starts are not recorded
+  TEST_CHECK(pinPage(bm, h, 0));
+  TEST_CHECK(unpinPage(bm, h));
+
+  TEST_CHECK(startBufferTrace(bm, TEST_TRACE_FILE));
+  rc = startBufferTrace(bm, TEST_TRACE_FILE);
+  ASSERT_EQUALS_INT(RC_BM_TRACE_ALREADY_RUNNING, rc, "one trace per pool");
+  TEST_CHECK(pinPage(bm, h, 1));
+  TEST_CHECK(markDirty(bm, h));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPages(bm, pages, pageNums, 2));
+  TEST_CHECK(unpinPage(bm, &pages[0]));
+  TEST_CHECK(unpinPage(bm, &pages[1]));
+  TEST_CHECK(pinPage(bm, h, 1));
+  TEST_CHECK(stopBufferTrace(bm));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(stopBufferTrace(bm));
+
+  file = fopen(TEST_TRACE_FILE, "rb");
+  ASSERT_TRUE(file != NULL, "trace file created");
+  ASSERT_TRUE(fread(&header, sizeof(BM_TraceHeader), 1, file) == 1, "trace header read");
+  ASSERT_TRUE(memcmp(header.magic, BM_TRACE_MAGIC, sizeof(header.magic)) == 0, "trace magic");
+  ASSERT_EQUALS_INT(3, header.numFrames, "pool size in the header");
+  ASSERT_EQUALS_INT(RS_LRU, header.strategy, "strategy in the header");
+  for(i = 0; i < 8; i++)
+    {
+      ASSERT_TRUE(fread(&record, sizeof(BM_TraceRecord), 1, file) == 1, "trace record read");
+      ASSERT_EQUALS_INT(expected[i][0], record.pageNum, "page of the record");
+      ASSERT_EQUALS_INT(expected[i][1], record.op, "op of the record");
+      ASSERT_EQUALS_INT(bm->fileId, record.fileId, "file of the record");
+    }
+  ASSERT_TRUE(fread(&record, sizeof(BM_TraceRecord), 1, file) == 0, "nothing recorded after stop");
+  fclose(file);
+  remove(TEST_TRACE_FILE);
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_PAGE_FILE));
+
+  free(h);
+  free(bm);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+createDummyPages (int num)
+{
+  SM_FileHandle fh;
+  char data[PAGE_SIZE];
+  int i;
+
+  TEST_CHECK(createPageFile(TEST_PAGE_FILE));
+  TEST_CHECK(openPageFile(TEST_PAGE_FILE, &fh));
+  TEST_CHECK(ensureCapacity(num, &fh));
+  for(i = 0; i < num; i++)
+    {
+      memset(data, 0, PAGE_SIZE);
+      sprintf(data, "%s-%i", "Page", i);
+      TEST_CHECK(writeBlock(i, &fh, data));
+    }
+  TEST_CHECK(closePageFile(&fh));
+}
+
+// ************************************************************
+int
+fixCountOf (BM_BufferPool *bm, PageNumber pageNum)
+{
+  PageNumber *frames = getFrameContents(bm);
+  int *fixCounts = getFixCounts(bm);
+  int i;
+
+  for(i = 0; i < bm->numPages; i++)
+    if (frames[i] == pageNum)
+      return fixCounts[i];
+  return -1;
+}
+
+// ************************************************************
+void *
+pinPagesThread (void *arg)
+{
+  ThreadPin *pin = (ThreadPin *) arg;
+
+  pin->rc = pinPages(pin->bm, pin->pages, pin->pageNums, 2);
+  return NULL;
+}
+
+// ************************************************************
+void *
+pinPageThread (void *arg)
+{
+  ThreadPin *pin = (ThreadPin *) arg;
+
+  pin->rc = pinPage(pin->bm, &pin->pages[0], pin->pageNums[0]);
+  if (pin->rc == RC_OK)
+    memcpy(pin->seen, pin->pages[0].data, PAGE_SIZE);
+  return NULL;
+}
+
+// ************************************************************
+// pins pages 0 to 3 round robin in a private pool of two frames, returns its hits and misses in pageNums
+void *
+pinLoopThread (void *arg)
+{
+  ThreadPin *pin = (ThreadPin *) arg;
+  BM_BufferPool bm;
+  BM_PoolStats stats;
+  int i;
+
+  pin->rc = initBufferPool(&bm, TEST_PAGE_FILE, 2, RS_FIFO, NULL);
+  for(i = 0; i < 2000 && pin->rc == RC_OK; i++)
+    {
+      pin->rc = pinPage(&bm, &pin->pages[0], (i / 3) % 4);
+      if (pin->rc == RC_OK)
+	pin->rc = unpinPage(&bm, &pin->pages[0]);
+    }
+  getPoolStats(&bm, &stats);
+  pin->pageNums[0] = stats.hits;
+  pin->pageNums[1] = stats.misses;
+  if (pin->rc == RC_OK)
+    pin->rc = shutdownBufferPool(&bm);
+  return NULL;
+}
+
+// ************************************************************
+void
+readPageFromDisk (PageNumber pageNum, char *data)
+{
+  SM_FileHandle fh;
+
+  TEST_CHECK(openPageFile(TEST_PAGE_FILE, &fh));
+  TEST_CHECK(readBlock(pageNum, &fh, data));
+  TEST_CHECK(closePageFile(&fh));
+}
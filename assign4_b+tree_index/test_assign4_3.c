@@ -0,0 +1,1158 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+
+#include "dberror.h"
+#include "storage_mgr.h"
+#include "buffer_mgr.h"
+#include "expr.h"
+#include "record_mgr.h"
+#include "table_loader.h"
+#include "batch_filter.h"
+#include "tables.h"
+#include "test_helper.h"
+
+#define ASSERT_EQUALS_RECORDS(_l,_r, schema, message)			\
+  do {									\
+    Record *_lR = _l;							\
+    Record *_rR = _r;							\
+    ASSERT_TRUE(memcmp(_lR->data,_rR->data,getRecordSize(schema)) == 0, message); \
+  } while(0)
+
+// test methods
+static void testSlottedPages (void);
+static void testFreeSpaceReuse (void);
+static void testTableHeader (void);
+static void testBulkLoad (void);
+static void testParallelLoader (void);
+static void testRedoRecovery (void);
+static void testForcedCrash (void);
+static void testCheckpointWithPin (void);
+static void testZeroCopyRecords (void);
+static void testNextBatch (void);
+static void testFilterKernels (void);
+
+// helper methods
+static Record *testRecord (Schema *schema, int a, char *b, int c);
+static Schema *testSchema (void);
+static Schema *allTypesSchema (void);
+
+// test name
+char *testName;
+
+// main method
+int
+main (void)
+{
+  testName = "";
+
+  testSlottedPages();
+  testFreeSpaceReuse();
+  testTableHeader();
+  testBulkLoad();
+  testParallelLoader();
+  testRedoRecovery();
+  testForcedCrash();
+  testCheckpointWithPin();
+  testZeroCopyRecords();
+  testNextBatch();
+  testFilterKernels();
+
+  return 0;
+}
+
+// ************************************************************
+void
+testSlottedPages (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  int numInserts = 1000, numDeleted = 0, numScanned = 0, i;
+  RID *rids = (RID *) malloc(sizeof(RID) * numInserts);
+  RM_ScanHandle sc;
+  Record *r, *expected;
+  Schema *schema;
+  testName = "many records share a slotted heap page";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_s", schema));
+  TEST_CHECK(openTable(table, "test_table_s"));
+
+  for(i = 0; i < numInserts; i++)
+    {
+      r = testRecord(schema, i, "abcd", 2 * i);
+      TEST_CHECK(insertRecord(table, r));
+      rids[i] = r->id;
+      freeRecord(r);
+    }
+
+  // page 0 holds the header, page 1 the free-space map, 12 byte tuples and their slots fill a page 255 times
+  ASSERT_EQUALS_INT(2, rids[0].page, "first record on the first heap page");
+  ASSERT_EQUALS_INT(0, rids[0].slot, "first record in the first slot");
+  ASSERT_EQUALS_INT(2, rids[254].page, "255 records on one page");
+  ASSERT_EQUALS_INT(254, rids[254].slot, "one slot per record");
+  ASSERT_EQUALS_INT(3, rids[255].page, "record 256 starts the next page");
+  ASSERT_EQUALS_INT(5, rids[numInserts - 1].page, "1000 records on four pages");
+
+  // records are found by page and slot after reopening
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_s"));
+  TEST_CHECK(createRecord(&r, schema));
+  for(i = 0; i < numInserts; i++)
+    {
+      TEST_CHECK(getRecord(table, rids[i], r));
+      expected = testRecord(schema, i, "abcd", 2 * i);
+      ASSERT_EQUALS_RECORDS(expected, r, schema, "record read back");
+      freeRecord(expected);
+    }
+
+  // deleting frees the slot, the other records of the page keep theirs
+  for(i = 1; i < 255; i += 2)
+    {
+      TEST_CHECK(deleteRecord(table, rids[i]));
+      numDeleted++;
+    }
+  ASSERT_ERROR(getRecord(table, rids[1], r), "deleted record is gone");
+  TEST_CHECK(getRecord(table, rids[2], r));
+  expected = testRecord(schema, 2, "abcd", 4);
+  ASSERT_EQUALS_RECORDS(expected, r, schema, "neighbour of a deleted record unchanged");
+  freeRecord(expected);
+  ASSERT_EQUALS_INT(numInserts - numDeleted, getNumTuples(table), "tuple count after deletes");
+
+  TEST_CHECK(startScan(table, &sc, NULL));
+  while(next(&sc, r) == RC_OK)
+    numScanned++;
+  TEST_CHECK(closeScan(&sc));
+  ASSERT_EQUALS_INT(numInserts - numDeleted, numScanned, "scan skips free slots");
+
+  freeRecord(r);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_s"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testFreeSpaceReuse (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  int numInserts = 1000, numRefilled = 0, i;
+  RID *rids = (RID *) malloc(sizeof(RID) * numInserts);
+  RM_TableStats stats;
+  int pagesBefore;
+  Record *r;
+  Schema *schema;
+  testName = "inserts reuse the space of deleted records";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_f", schema));
+  TEST_CHECK(openTable(table, "test_table_f"));
+  for(i = 0; i < numInserts; i++)
+    {
+      r = testRecord(schema, i, "abcd", i);
+      TEST_CHECK(insertRecord(table, r));
+      rids[i] = r->id;
+      freeRecord(r);
+    }
+
+  // empty the second heap page, the map has to remember it across a reopen
+  for(i = 0; i < numInserts; i++)
+    if (rids[i].page == 3)
+      TEST_CHECK(deleteRecord(table, rids[i]));
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_f"));
+  TEST_CHECK(getTableStats(table, &stats));
+  pagesBefore = (int) stats.pagesAppended;
+
+  for(i = 0; i < 255; i++)
+    {
+      r = testRecord(schema, numInserts + i, "efgh", i);
+      TEST_CHECK(insertRecord(table, r));
+      if (r->id.page == 3)
+	numRefilled++;
+      freeRecord(r);
+    }
+  ASSERT_EQUALS_INT(255, numRefilled, "freed page refilled");
+  TEST_CHECK(getTableStats(table, &stats));
+  ASSERT_EQUALS_INT(pagesBefore, (int) stats.pagesAppended, "no page appended while one has room");
+
+  // the refilled page is full again, the next insert goes to the last page which has room
+  r = testRecord(schema, 2 * numInserts, "ijkl", 0);
+  TEST_CHECK(insertRecord(table, r));
+  ASSERT_EQUALS_INT(5, r->id.page, "full pages are skipped");
+  freeRecord(r);
+  ASSERT_EQUALS_INT(numInserts + 1, getNumTuples(table), "tuple count");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_f"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testForcedCrash (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  int numInserts = 1000, numScanned = 0, status, i;
+  RID *rids = (RID *) malloc(sizeof(RID) * numInserts);
+  RM_ScanHandle sc;
+  Record *r, *expected;
+  Schema *schema;
+  pid_t child;
+  testName = "forced changes are counted after a crash";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_f", schema));
+  TEST_CHECK(openTable(table, "test_table_f"));
+  r = testRecord(schema, -1, "old", 0);
+  TEST_CHECK(insertRecord(table, r));
+  freeRecord(r);
+  TEST_CHECK(closeTable(table));
+
+  // the child appends pages with RM_WRITE_FORCE and dies without closing, the header on disk is the one of close
+  child = fork();
+  if (child == 0)
+    {
+      TEST_CHECK(openTable(table, "test_table_f"));
+      for(i = 0; i < numInserts; i++)
+	{
+	  r = testRecord(schema, i, "abcd", i);
+	  TEST_CHECK(insertRecord(table, r));
+	  rids[i] = r->id;
+	  freeRecord(r);
+	}
+      for(i = 0; i < numInserts; i += 10)
+	TEST_CHECK(deleteRecord(table, rids[i]));
+      fflush(stdout);
+      _exit(0);
+    }
+  ASSERT_TRUE(child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0,
+	      "crashed writer ran");
+
+  TEST_CHECK(openTable(table, "test_table_f"));
+  ASSERT_EQUALS_INT(numInserts - numInserts / 10 + 1, getNumTuples(table), "tuple count recounted");
+  TEST_CHECK(createRecord(&r, schema));
+  TEST_CHECK(startScan(table, &sc, NULL));
+  while(next(&sc, r) == RC_OK)
+    {
+      rids[numScanned % numInserts] = r->id;
+      numScanned++;
+    }
+  TEST_CHECK(closeScan(&sc));
+  ASSERT_EQUALS_INT(numInserts - numInserts / 10 + 1, numScanned, "rows on the appended pages scanned");
+
+  // new rows go to free space or behind the last page, the rows of the child stay
+  for(i = 0; i < numInserts; i++)
+    {
+      expected = testRecord(schema, numInserts + i, "new", 0);
+      TEST_CHECK(insertRecord(table, expected));
+      freeRecord(expected);
+    }
+  TEST_CHECK(getRecord(table, rids[(numScanned - 1) % numInserts], r));
+  expected = testRecord(schema, numInserts - 1, "abcd", numInserts - 1);
+  ASSERT_EQUALS_RECORDS(expected, r, schema, "row of the crashed writer kept");
+  freeRecord(expected);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_f"));
+  ASSERT_EQUALS_INT(2 * numInserts - numInserts / 10 + 1, getNumTuples(table), "tuple count after reopening");
+
+  freeRecord(r);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_f"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testCheckpointWithPin (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  int numInserts = 300, status, i;
+  RID *rids = (RID *) malloc(sizeof(RID) * numInserts);
+  Record pinned;
+  Record *r, *expected;
+  Schema *schema;
+  struct stat logStat;
+  pid_t child;
+  RC rc;
+  testName = "a checkpoint keeps the log of pinned pages";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_p", schema));
+  TEST_CHECK(openTable(table, "test_table_p"));
+  for(i = 0; i < numInserts; i++)
+    {
+      r = testRecord(schema, i, "abcd", i);
+      TEST_CHECK(insertRecord(table, r));
+      rids[i] = r->id;
+      freeRecord(r);
+    }
+  TEST_CHECK(closeTable(table));
+
+  // the child modifies a page while a record of it is pinned, checkpoints and dies
+  child = fork();
+  if (child == 0)
+    {
+      TEST_CHECK(openTable(table, "test_table_p"));
+      TEST_CHECK(setWritePolicy(table, RM_WRITE_BACK));
+      TEST_CHECK(pinRecord(table, rids[0], &pinned));
+      r = testRecord(schema, 1, "upd", -1);
+      r->id = rids[1];
+      TEST_CHECK(updateRecord(table, r));
+      freeRecord(r);
+      rc = checkpointTable(table);
+      ASSERT_EQUALS_INT(RC_BM_FRAMES_PINNED, rc, "modified page is pinned");
+      ASSERT_TRUE(stat("test_table_p.log", &logStat) == 0 && logStat.st_size > 0, "log kept");
+      TEST_CHECK(syncTableLog(table));
+      fflush(stdout);
+      _exit(0);
+    }
+  ASSERT_TRUE(child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0,
+	      "crashed writer ran");
+
+  // the update is redone from the log
+  TEST_CHECK(openTable(table, "test_table_p"));
+  TEST_CHECK(createRecord(&r, schema));
+  TEST_CHECK(getRecord(table, rids[1], r));
+  expected = testRecord(schema, 1, "upd", -1);
+  ASSERT_EQUALS_RECORDS(expected, r, schema, "update of the pinned page recovered");
+  freeRecord(expected);
+  ASSERT_EQUALS_INT(numInserts, getNumTuples(table), "tuple count recovered");
+
+  // after the pin is released the checkpoint writes the page and empties the log
+  TEST_CHECK(setWritePolicy(table, RM_WRITE_BACK));
+  TEST_CHECK(pinRecord(table, rids[0], &pinned));
+  expected = testRecord(schema, 2, "new", -2);
+  expected->id = rids[2];
+  TEST_CHECK(updateRecord(table, expected));
+  ASSERT_ERROR(checkpointTable(table), "modified page is pinned");
+  TEST_CHECK(releaseRecord(table, &pinned));
+  TEST_CHECK(checkpointTable(table));
+  ASSERT_TRUE(stat("test_table_p.log", &logStat) == 0 && logStat.st_size == 0, "log emptied");
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_p"));
+  TEST_CHECK(getRecord(table, rids[2], r));
+  ASSERT_EQUALS_RECORDS(expected, r, schema, "checkpointed update kept");
+  freeRecord(expected);
+
+  freeRecord(r);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_p"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testTableHeader (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  RID rids[10];
+  RM_TableStats stats;
+  RM_ScanHandle sc;
+  Record *r;
+  Schema *schema;
+  RC rc;
+  int i;
+  testName = "table header survives closing the table";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_h", schema));
+  TEST_CHECK(openTable(table, "test_table_h"));
+  for(i = 0; i < 10; i++)
+    {
+      r = testRecord(schema, i, "abcd", i);
+      TEST_CHECK(insertRecord(table, r));
+      rids[i] = r->id;
+      freeRecord(r);
+    }
+  for(i = 0; i < 3; i++)
+    {
+      r = testRecord(schema, i, "wxyz", -i);
+      r->id = rids[i];
+      TEST_CHECK(updateRecord(table, r));
+      freeRecord(r);
+    }
+  TEST_CHECK(deleteRecord(table, rids[8]));
+  TEST_CHECK(deleteRecord(table, rids[9]));
+  TEST_CHECK(startScan(table, &sc, NULL));
+  TEST_CHECK(closeScan(&sc));
+  TEST_CHECK(closeTable(table));
+
+  // the counts come from the header, no scan needed
+  TEST_CHECK(openTable(table, "test_table_h"));
+  ASSERT_EQUALS_INT(8, getNumTuples(table), "tuple count read from the header");
+  TEST_CHECK(getTableStats(table, &stats));
+  ASSERT_EQUALS_INT(10, (int) stats.inserts, "inserts counted");
+  ASSERT_EQUALS_INT(2, (int) stats.deletes, "deletes counted");
+  ASSERT_EQUALS_INT(3, (int) stats.updates, "updates counted");
+  ASSERT_EQUALS_INT(1, (int) stats.scans, "scans counted");
+  ASSERT_EQUALS_INT(1, (int) stats.pagesAppended, "one heap page appended");
+
+  // the schema stored behind the header
+  ASSERT_EQUALS_INT(3, table->schema->numAttr, "number of attributes");
+  ASSERT_EQUALS_STRING("b", table->schema->attrNames[1], "attribute name");
+  ASSERT_EQUALS_INT(DT_STRING, table->schema->dataTypes[1], "attribute type");
+  ASSERT_EQUALS_INT(4, table->schema->typeLength[1], "string length");
+  ASSERT_EQUALS_INT(1, table->schema->keySize, "key size");
+  ASSERT_EQUALS_INT(0, table->schema->keyAttrs[0], "key attribute");
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_h"));
+
+  // a page file without a table header is refused
+  TEST_CHECK(createPageFile("test_table_x"));
+  rc = openTable(table, "test_table_x");
+  ASSERT_EQUALS_INT(RC_RM_BAD_TABLE_HEADER, rc, "not a table");
+  TEST_CHECK(destroyPageFile("test_table_x"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testBulkLoad (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  int numRecords = 600, numStreamed = 17000, numScanned = 0, i;
+  Record **records = (Record **) malloc(sizeof(Record *) * numRecords);
+  RID *rids = (RID *) malloc(sizeof(RID) * numStreamed);
+  char *tuples;
+  char page[PAGE_SIZE];
+  RM_BulkLoader loader;
+  RM_TableStats stats;
+  RM_ScanHandle sc;
+  Record *r, *expected;
+  Schema *schema;
+  int pagesBefore;
+  testName = "bulk loading fills pages directly";
+  schema = testSchema();
+  tuples = (char *) malloc(10 * getRecordSize(schema));
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_b", schema));
+  TEST_CHECK(openTable(table, "test_table_b"));
+
+  // insertRecords packs the records in order and sets their ids
+  for(i = 0; i < numRecords; i++)
+    records[i] = testRecord(schema, i, "abcd", i);
+  TEST_CHECK(insertRecords(table, records, numRecords));
+  ASSERT_EQUALS_INT(2, records[0]->id.page, "first record on the first heap page");
+  ASSERT_EQUALS_INT(254, records[254]->id.slot, "255 records on a page");
+  ASSERT_EQUALS_INT(3, records[255]->id.page, "next record on the next page");
+  ASSERT_EQUALS_INT(numRecords, getNumTuples(table), "tuple count after insertRecords");
+  TEST_CHECK(createRecord(&r, schema));
+  for(i = 0; i < numRecords; i++)
+    {
+      TEST_CHECK(getRecord(table, records[i]->id, r));
+      ASSERT_EQUALS_RECORDS(records[i], r, schema, "bulk inserted record read back");
+      freeRecord(records[i]);
+    }
+
+  // a streamed load over more than one extent, then a page built by the caller
+  TEST_CHECK(startBulkLoad(table, &loader));
+  for(i = 0; i < numStreamed; i++)
+    {
+      expected = testRecord(schema, numRecords + i, "efgh", i);
+      TEST_CHECK(bulkLoadRecord(&loader, expected));
+      rids[i] = expected->id;
+      freeRecord(expected);
+    }
+  for(i = 0; i < 10; i++)
+    {
+      expected = testRecord(schema, -i, "page", i);
+      memcpy(tuples + i * getRecordSize(schema), expected->data, getRecordSize(schema));
+      freeRecord(expected);
+    }
+  ASSERT_EQUALS_INT(10, buildHeapPage(schema, page, tuples, 10), "all tuples fit on the page");
+  TEST_CHECK(bulkLoadPage(&loader, page));
+  TEST_CHECK(finishBulkLoad(&loader));
+  ASSERT_EQUALS_INT(numRecords + numStreamed + 10, getNumTuples(table), "tuple count after the bulk load");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_b"));
+  for(i = 0; i < numStreamed; i += 97)
+    {
+      TEST_CHECK(getRecord(table, rids[i], r));
+      expected = testRecord(schema, numRecords + i, "efgh", i);
+      ASSERT_EQUALS_RECORDS(expected, r, schema, "streamed record read back");
+      freeRecord(expected);
+    }
+  TEST_CHECK(startScan(table, &sc, NULL));
+  while(next(&sc, r) == RC_OK)
+    numScanned++;
+  TEST_CHECK(closeScan(&sc));
+  ASSERT_EQUALS_INT(numRecords + numStreamed + 10, numScanned, "scan finds every loaded record");
+
+  // the free-space map knows the pages the load left room on
+  TEST_CHECK(getTableStats(table, &stats));
+  pagesBefore = (int) stats.pagesAppended;
+  expected = testRecord(schema, 0, "ijkl", 0);
+  TEST_CHECK(insertRecord(table, expected));
+  freeRecord(expected);
+  TEST_CHECK(getTableStats(table, &stats));
+  ASSERT_EQUALS_INT(pagesBefore, (int) stats.pagesAppended, "insert after a load uses a loaded page");
+
+  freeRecord(r);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_b"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(tuples);
+  free(rids);
+  free(records);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testParallelLoader (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  int numRows = 5000, numScanned = 0, i;
+  int widths[] = {6, 4, 6};
+  char name[5];
+  RM_LoadOptions options;
+  RM_LoadStats stats;
+  RM_ScanHandle sc;
+  Record *r, *expected;
+  Schema *schema;
+  FILE *file;
+  RC rc;
+  testName = "loading delimited, fixed width and binary files with several workers";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_l", schema));
+  TEST_CHECK(openTable(table, "test_table_l"));
+
+  // a header line, good rows and three rows that do not convert
+  file = fopen("test_load.csv", "w");
+  fprintf(file, "a,b,c\n");
+  for(i = 0; i < numRows; i++)
+    {
+      fprintf(file, "%i,r%i,%i\n", i, i % 100, -i);
+      if (i == 10)
+	fprintf(file, "x,abcd,1\n1,abcdefg,2\n1,ab\n");
+    }
+  fclose(file);
+
+  // small chunks, so the workers finish them out of order
+  TEST_CHECK(initLoadOptions(&options));
+  options.skipHeader = TRUE;
+  options.numWorkers = 4;
+  options.chunkSize = 4096;
+  TEST_CHECK(loadTable(table, "test_load.csv", &options, &stats));
+  ASSERT_EQUALS_INT(numRows, (int) stats.rows, "rows loaded");
+  ASSERT_EQUALS_INT(3, (int) stats.rejectedRows, "bad rows rejected");
+  ASSERT_EQUALS_INT(numRows, getNumTuples(table), "tuple count");
+
+  // the table holds the rows in file order, short strings are padded
+  TEST_CHECK(createRecord(&r, schema));
+  TEST_CHECK(startScan(table, &sc, NULL));
+  while(next(&sc, r) == RC_OK)
+    {
+      sprintf(name, "r%i", numScanned % 100);
+      expected = testRecord(schema, numScanned, name, -numScanned);
+      ASSERT_EQUALS_RECORDS(expected, r, schema, "row loaded in file order");
+      freeRecord(expected);
+      numScanned++;
+    }
+  TEST_CHECK(closeScan(&sc));
+  ASSERT_EQUALS_INT(numRows, numScanned, "every row scanned");
+
+  // fixed width fields, blanks around a value are ignored
+  file = fopen("test_load.txt", "w");
+  fprintf(file, "  9001abcd  -1\n9002  ef    -2\n");
+  fclose(file);
+  TEST_CHECK(initLoadOptions(&options));
+  options.format = RM_LOAD_FIXED_WIDTH;
+  options.fieldWidths = widths;
+  TEST_CHECK(loadTable(table, "test_load.txt", &options, &stats));
+  ASSERT_EQUALS_INT(2, (int) stats.rows, "fixed width rows loaded");
+
+  // binary rows are copied as they are
+  file = fopen("test_load.bin", "w");
+  for(i = 0; i < 3; i++)
+    {
+      expected = testRecord(schema, 9100 + i, "bin", i);
+      fwrite(expected->data, getRecordSize(schema), 1, file);
+      freeRecord(expected);
+    }
+  fclose(file);
+  TEST_CHECK(initLoadOptions(&options));
+  options.format = RM_LOAD_BINARY;
+  TEST_CHECK(loadTable(table, "test_load.bin", &options, &stats));
+  ASSERT_EQUALS_INT(3, (int) stats.rows, "binary rows loaded");
+  ASSERT_EQUALS_INT(numRows + 5, getNumTuples(table), "tuple count after three loads");
+
+  TEST_CHECK(startScan(table, &sc, NULL));
+  for(i = 0; i < numRows + 5 && next(&sc, r) == RC_OK; i++)
+    {
+      if (i == numRows + 1)
+	{
+	  expected = testRecord(schema, 9002, "ef", -2);
+	  ASSERT_EQUALS_RECORDS(expected, r, schema, "fixed width row");
+	  freeRecord(expected);
+	}
+      if (i == numRows + 4)
+	{
+	  expected = testRecord(schema, 9102, "bin", 2);
+	  ASSERT_EQUALS_RECORDS(expected, r, schema, "binary row");
+	  freeRecord(expected);
+	}
+    }
+  TEST_CHECK(closeScan(&sc));
+
+  // errors
+  TEST_CHECK(initLoadOptions(&options));
+  rc = loadTable(table, "test_load_missing.csv", &options, NULL);
+  ASSERT_EQUALS_INT(RC_FILE_NOT_FOUND, rc, "missing load file");
+  options.format = RM_LOAD_FIXED_WIDTH;
+  rc = loadTable(table, "test_load.txt", &options, NULL);
+  ASSERT_EQUALS_INT(RC_RM_INVALID_LOAD_OPTIONS, rc, "fixed width needs widths");
+  ASSERT_EQUALS_INT(numRows + 5, getNumTuples(table), "failed loads add nothing");
+
+  remove("test_load.csv");
+  remove("test_load.txt");
+  remove("test_load.bin");
+  freeRecord(r);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_l"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testRedoRecovery (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  int numInserts = 2000, numScanned = 0, status, i;
+  RID *rids = (RID *) malloc(sizeof(RID) * numInserts);
+  RM_ScanHandle sc;
+  Record *r, *expected;
+  Schema *schema;
+  pid_t child;
+  testName = "write-back changes are redone after a crash";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_w", schema));
+
+  // the child modifies the table with RM_WRITE_BACK and dies without closing it
+  child = fork();
+  if (child == 0)
+    {
+      TEST_CHECK(openTable(table, "test_table_w"));
+      TEST_CHECK(setWritePolicy(table, RM_WRITE_BACK));
+      for(i = 0; i < numInserts; i++)
+	{
+	  r = testRecord(schema, i, "abcd", i);
+	  TEST_CHECK(insertRecord(table, r));
+	  rids[i] = r->id;
+	  freeRecord(r);
+	}
+      TEST_CHECK(checkpointTable(table));
+      for(i = 0; i < numInserts; i += 7)
+	{
+	  r = testRecord(schema, i, "upd", -i);
+	  r->id = rids[i];
+	  TEST_CHECK(updateRecord(table, r));
+	  freeRecord(r);
+	}
+      for(i = 0; i < numInserts; i += 5)
+	TEST_CHECK(deleteRecord(table, rids[i]));
+      TEST_CHECK(syncTableLog(table));
+      fflush(stdout);
+      _exit(0);
+    }
+  ASSERT_TRUE(child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0,
+	      "crashed writer ran");
+  ASSERT_TRUE(access("test_table_w.log", F_OK) == 0, "redo log left behind");
+
+  // opening replays the log: the rows after the checkpoint are back without a page write of theirs
+  TEST_CHECK(openTable(table, "test_table_w"));
+  ASSERT_TRUE(access("test_table_w.log", F_OK) != 0, "log removed after recovery");
+  ASSERT_EQUALS_INT(numInserts - numInserts / 5, getNumTuples(table), "tuple count recovered");
+  TEST_CHECK(createRecord(&r, schema));
+  TEST_CHECK(startScan(table, &sc, NULL));
+  while(next(&sc, r) == RC_OK)
+    {
+      Value *a;
+      TEST_CHECK(getAttr(r, schema, 0, &a));
+      ASSERT_TRUE(a->v.intV % 5 != 0, "deleted row stays deleted");
+      if (a->v.intV % 7 == 0)
+	expected = testRecord(schema, a->v.intV, "upd", -a->v.intV);
+      else
+	expected = testRecord(schema, a->v.intV, "abcd", a->v.intV);
+      ASSERT_EQUALS_RECORDS(expected, r, schema, "row recovered");
+      freeRecord(expected);
+      freeVal(a);
+      numScanned++;
+    }
+  TEST_CHECK(closeScan(&sc));
+  ASSERT_EQUALS_INT(numInserts - numInserts / 5, numScanned, "every surviving row scanned");
+
+  // the recovered table takes new rows and opens cleanly
+  expected = testRecord(schema, numInserts, "new", 0);
+  TEST_CHECK(insertRecord(table, expected));
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_w"));
+  ASSERT_EQUALS_INT(numInserts - numInserts / 5 + 1, getNumTuples(table), "tuple count after reopening");
+  TEST_CHECK(getRecord(table, expected->id, r));
+  ASSERT_EQUALS_RECORDS(expected, r, schema, "row inserted after recovery");
+  freeRecord(expected);
+
+  freeRecord(r);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_w"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testZeroCopyRecords (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  int numInserts = 600, numScanned = 0, i;
+  RID *rids = (RID *) malloc(sizeof(RID) * numInserts);
+  Record pinned, again, inPlace;
+  RM_ScanHandle sc;
+  Record *r, *expected;
+  Schema *schema;
+  RC rc;
+  testName = "records pointing into pinned pages";
+  schema = testSchema();
+
+  // the global pool refuses to close a table while one of its pages is pinned
+  TEST_CHECK(initGlobalBufferPool(10, RS_LRU, NULL));
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_z", schema));
+  TEST_CHECK(openTable(table, "test_table_z"));
+  for(i = 0; i < numInserts; i++)
+    {
+      r = testRecord(schema, i, "abcd", i);
+      TEST_CHECK(insertRecord(table, r));
+      rids[i] = r->id;
+      freeRecord(r);
+    }
+
+  // pinRecord points into the frame, two pins of a record see the same bytes
+  for(i = 0; i < numInserts; i++)
+    {
+      TEST_CHECK(pinRecord(table, rids[i], &pinned));
+      expected = testRecord(schema, i, "abcd", i);
+      ASSERT_EQUALS_RECORDS(expected, &pinned, schema, "pinned record has its content");
+      freeRecord(expected);
+      TEST_CHECK(releaseRecord(table, &pinned));
+    }
+  TEST_CHECK(pinRecord(table, rids[3], &pinned));
+  TEST_CHECK(pinRecord(table, rids[3], &again));
+  ASSERT_TRUE(pinned.data == again.data, "no copy of the tuple");
+  TEST_CHECK(releaseRecord(table, &again));
+
+  // an update of the pinned record shows through it
+  expected = testRecord(schema, 3, "upd", -3);
+  expected->id = rids[3];
+  TEST_CHECK(updateRecord(table, expected));
+  ASSERT_EQUALS_RECORDS(expected, &pinned, schema, "pinned record sees the update");
+  freeRecord(expected);
+
+  rc = closeTable(table);
+  ASSERT_EQUALS_INT(RC_BM_FRAMES_PINNED, rc, "table with a pinned record stays open");
+  TEST_CHECK(releaseRecord(table, &pinned));
+
+  TEST_CHECK(deleteRecord(table, rids[4]));
+  rc = pinRecord(table, rids[4], &pinned);
+  ASSERT_EQUALS_INT(RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD, rc, "deleted record cannot be pinned");
+  pinned.id.page = 100;
+  pinned.id.slot = 0;
+  rc = pinRecord(table, pinned.id, &pinned);
+  ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "page beyond the table");
+
+  // nextInPlace hands out the same addresses, the scan holds the page while it is on it
+  TEST_CHECK(startScan(table, &sc, NULL));
+  while(nextInPlace(&sc, &inPlace) == RC_OK)
+    {
+      TEST_CHECK(pinRecord(table, inPlace.id, &pinned));
+      ASSERT_TRUE(pinned.data == inPlace.data, "scan record points into the frame");
+      TEST_CHECK(releaseRecord(table, &pinned));
+      numScanned++;
+    }
+  ASSERT_EQUALS_INT(numInserts - 1, numScanned, "every record scanned in place");
+  TEST_CHECK(closeScan(&sc));
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_z"));
+  TEST_CHECK(shutdownRecordManager());
+  TEST_CHECK(shutdownGlobalBufferPool());
+
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testNextBatch (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  int numInserts = 5000, numRows, numSelected, row, k, i;
+  char name[5];
+  RecordBatch *batch;
+  RM_ScanHandle sc;
+  Expr *sel, *left, *right;
+  Record *r;
+  Schema *schema;
+  RC rc;
+  testName = "scanning into column batches";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_n", schema));
+  TEST_CHECK(openTable(table, "test_table_n"));
+  for(i = 0; i < numInserts; i++)
+    {
+      sprintf(name, "r%i", i % 100);
+      r = testRecord(schema, i, name, i % 10);
+      TEST_CHECK(insertRecord(table, r));
+      freeRecord(r);
+    }
+  TEST_CHECK(createRecordBatch(&batch, schema, 1000));
+  TEST_CHECK(createRecord(&r, schema));
+
+  // without a condition every row is selected, the columns hold the rows in table order
+  numRows = 0;
+  TEST_CHECK(startScan(table, &sc, NULL));
+  while((rc = nextBatch(&sc, batch, 0)) == RC_OK)
+    {
+      ASSERT_TRUE(batch->numRows <= 1000, "batch within its capacity");
+      ASSERT_EQUALS_INT(batch->numRows, batch->numSelected, "all rows selected");
+      for(row = 0; row < batch->numRows; row++)
+	{
+	  sprintf(name, "r%i", numRows % 100);
+	  if (((int *) batch->columns[0])[row] != numRows
+	      || strncmp(batch->columns[1] + row * 4, name, 4) != 0
+	      || ((int *) batch->columns[2])[row] != numRows % 10)
+	    break;
+	  numRows++;
+	}
+      ASSERT_EQUALS_INT(batch->numRows, row, "columns hold the rows in order");
+    }
+  ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "scan ends");
+  ASSERT_EQUALS_INT(numInserts, numRows, "every row read");
+  TEST_CHECK(closeScan(&sc));
+
+  // a comparison with a constant, rows are selected on the columns
+  MAKE_CONS(left, stringToValue("i3"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  numSelected = 0;
+  TEST_CHECK(startScan(table, &sc, sel));
+  while(nextBatch(&sc, batch, 700) == RC_OK)
+    {
+      ASSERT_TRUE(batch->numRows <= 700, "batch within the requested rows");
+      for(k = 0; k < batch->numSelected; k++)
+	{
+	  row = batch->sel[k];
+	  ASSERT_TRUE(k == 0 || batch->sel[k - 1] < row, "selection vector ascending");
+	  ASSERT_EQUALS_INT(3, ((int *) batch->columns[2])[row], "selected row satisfies the condition");
+	  TEST_CHECK(getRecord(table, batch->ids[row], r));
+	  ASSERT_TRUE(memcmp(r->data, batch->columns[0] + row * sizeof(int), sizeof(int)) == 0, "rid of the row");
+	  numSelected++;
+	}
+    }
+  TEST_CHECK(closeScan(&sc));
+  freeExpr(sel);
+  ASSERT_EQUALS_INT(numInserts / 10, numSelected, "rows with c = 3");
+
+  // a comparison of two attributes is evaluated per tuple, next and nextBatch may be mixed
+  MAKE_ATTRREF(left, 2);
+  MAKE_ATTRREF(right, 0);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_SMALLER);
+  TEST_CHECK(startScan(table, &sc, sel));
+  TEST_CHECK(next(&sc, r));
+  numSelected = 1;
+  while(nextBatch(&sc, batch, 0) == RC_OK)
+    {
+      if (numSelected == 1)
+	ASSERT_EQUALS_INT(11, ((int *) batch->columns[0])[batch->sel[0]], "batch continues after next");
+      numSelected += batch->numSelected;
+    }
+  TEST_CHECK(closeScan(&sc));
+  freeExpr(sel);
+  ASSERT_EQUALS_INT(numInserts - 10, numSelected, "rows with c < a");
+
+  freeRecord(r);
+  TEST_CHECK(freeRecordBatch(batch));
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_n"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testFilterKernels (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  char *constants[] = { "i-18", "i0", "i5", "i100", "f-3.0", "f0.5", "f2.75", "btrue", "bfalse", "ss3", "ss30000", "s" };
+  int attrs[] = { 0, 0, 0, 0, 1, 1, 1, 2, 2, 3, 3, 3 };
+  int numConstants = 12, numInserts = 2503, numRows = 0, level, op, c, row, i;
+  RM_FilterLevel original = getFilterLevel();
+  uint64_t *expected, *bits;
+  int *scalarSel;
+  char name[5], padded[4];
+  RecordBatch *batch;
+  RM_ScanHandle sc;
+  Expr *sel, *and, *left, *right, *cmp;
+  Value *value, *k;
+  Record *r;
+  Schema *schema;
+  testName = "vector filter kernels agree with the scalar kernels";
+  schema = allTypesSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_k", schema));
+  TEST_CHECK(openTable(table, "test_table_k"));
+  TEST_CHECK(createRecord(&r, schema));
+  for(i = 0; i < numInserts; i++)
+    {
+      MAKE_VALUE(value, DT_INT, i % 37 - 18);
+      TEST_CHECK(setAttr(r, schema, 0, value));
+      freeVal(value);
+      value = (Value *) malloc(sizeof(Value));
+      value->dt = DT_FLOAT;
+      value->v.floatV = (i % 13) * 0.5f - 3;
+      TEST_CHECK(setAttr(r, schema, 1, value));
+      value->dt = DT_BOOL;
+      value->v.boolV = (i % 3 == 0);
+      TEST_CHECK(setAttr(r, schema, 2, value));
+      free(value);
+      sprintf(name, "s%i", i % 7);
+      MAKE_STRING_VALUE(value, name);
+      TEST_CHECK(setAttr(r, schema, 3, value));
+      freeVal(value);
+      TEST_CHECK(insertRecord(table, r));
+    }
+
+  TEST_CHECK(createRecordBatch(&batch, schema, 1000));
+  expected = (uint64_t *) malloc(BITMAP_WORDS(1000) * sizeof(uint64_t));
+  bits = (uint64_t *) malloc(BITMAP_WORDS(1000) * sizeof(uint64_t));
+  scalarSel = (int *) malloc(1000 * sizeof(int));
+
+  // (a < 5 and not b) or s = 's3', evaluated on whole batches
+  MAKE_CONS(right, stringToValue("i5"));
+  MAKE_ATTRREF(left, 0);
+  MAKE_BINOP_EXPR(cmp, left, right, OP_COMP_SMALLER);
+  MAKE_ATTRREF(left, 2);
+  MAKE_UNOP_EXPR(right, left, OP_BOOL_NOT);
+  MAKE_BINOP_EXPR(and, cmp, right, OP_BOOL_AND);
+  MAKE_ATTRREF(left, 3);
+  MAKE_CONS(right, stringToValue("ss3"));
+  MAKE_BINOP_EXPR(cmp, left, right, OP_COMP_EQUAL);
+  MAKE_BINOP_EXPR(sel, and, cmp, OP_BOOL_OR);
+  ASSERT_TRUE(canFilterBatch(sel, schema), "condition runs on the columns");
+
+  TEST_CHECK(startScan(table, &sc, NULL));
+  while(nextBatch(&sc, batch, 0) == RC_OK)
+    {
+      numRows += batch->numRows;
+      for(c = 0; c < numConstants; c++)
+	{
+	  k = stringToValue(constants[c]);
+	  for(op = 0; op < 2; op++)
+	    {
+	      // the expected rows, compared one at a time
+	      memset(expected, 0, BITMAP_WORDS(batch->numRows) * sizeof(uint64_t));
+	      memset(padded, 0, 4);
+	      if (k->dt == DT_STRING)
+		memcpy(padded, k->v.stringV, strlen(k->v.stringV) < 4 ? strlen(k->v.stringV) : 4);
+	      for(row = 0; row < batch->numRows; row++)
+		{
+		  int diff;
+		  switch(k->dt)
+		    {
+		    case DT_INT:
+		      diff = (((int *) batch->columns[0])[row] > k->v.intV) - (((int *) batch->columns[0])[row] < k->v.intV);
+		      break;
+		    case DT_FLOAT:
+		      diff = (((float *) batch->columns[1])[row] > k->v.floatV) - (((float *) batch->columns[1])[row] < k->v.floatV);
+		      break;
+		    case DT_BOOL:
+		      diff = ((bool *) batch->columns[2])[row] - k->v.boolV;
+		      break;
+		    default:
+		      diff = memcmp(batch->columns[3] + row * 4, padded, 4);
+		      if (diff == 0 && strlen(k->v.stringV) > 4)
+			diff = -1;
+		      break;
+		    }
+		  if (op == 0 ? diff == 0 : diff < 0)
+		    expected[row >> 6] |= (uint64_t) 1 << (row & 63);
+		}
+
+	      // every kernel level finds exactly these rows, including the rows behind the last full register
+	      for(level = RM_FILTER_SCALAR; level <= RM_FILTER_AVX2; level++)
+		{
+		  setFilterLevel(level);
+		  TEST_CHECK(filterColumn(batch, attrs[c], op == 0 ? OP_COMP_EQUAL : OP_COMP_SMALLER, k, bits));
+		  if (memcmp(expected, bits, BITMAP_WORDS(batch->numRows) * sizeof(uint64_t)) != 0)
+		    break;
+		}
+	      ASSERT_EQUALS_INT(RM_FILTER_AVX2 + 1, level, constants[c]);
+	    }
+	  freeVal(k);
+	}
+
+      // whole conditions select the same rows at every level
+      setFilterLevel(RM_FILTER_SCALAR);
+      TEST_CHECK(filterBatch(batch, sel));
+      memcpy(scalarSel, batch->sel, batch->numSelected * sizeof(int));
+      i = batch->numSelected;
+      for(level = RM_FILTER_SSE2; level <= RM_FILTER_AVX2; level++)
+	{
+	  setFilterLevel(level);
+	  TEST_CHECK(filterBatch(batch, sel));
+	  ASSERT_EQUALS_INT(i, batch->numSelected, "same number of rows selected");
+	  ASSERT_TRUE(memcmp(scalarSel, batch->sel, i * sizeof(int)) == 0, "same rows selected");
+	}
+    }
+  TEST_CHECK(closeScan(&sc));
+  ASSERT_EQUALS_INT(numInserts, numRows, "every row filtered");
+  setFilterLevel(original);
+
+  freeExpr(sel);
+  free(scalarSel);
+  free(bits);
+  free(expected);
+  freeRecord(r);
+  TEST_CHECK(freeRecordBatch(batch));
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_k"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// ************************************************************
+Schema *
+testSchema (void)
+{
+  Schema *result;
+  char *names[] = { "a", "b", "c" };
+  DataType dt[] = { DT_INT, DT_STRING, DT_INT };
+  int sizes[] = { 0, 4, 0 };
+  int keys[] = {0};
+  int i;
+  char **cpNames = (char **) malloc(sizeof(char*) * 3);
+  DataType *cpDt = (DataType *) malloc(sizeof(DataType) * 3);
+  int *cpSizes = (int *) malloc(sizeof(int) * 3);
+  int *cpKeys = (int *) malloc(sizeof(int));
+
+  for(i = 0; i < 3; i++)
+    {
+      cpNames[i] = (char *) malloc(2);
+      strcpy(cpNames[i], names[i]);
+    }
+  memcpy(cpDt, dt, sizeof(DataType) * 3);
+  memcpy(cpSizes, sizes, sizeof(int) * 3);
+  memcpy(cpKeys, keys, sizeof(int));
+
+  result = createSchema(3, cpNames, cpDt, cpSizes, 1, cpKeys);
+
+  return result;
+}
+
+// ************************************************************
+Schema *
+allTypesSchema (void)
+{
+  char *names[] = { "a", "f", "b", "s" };
+  DataType dt[] = { DT_INT, DT_FLOAT, DT_BOOL, DT_STRING };
+  int sizes[] = { 0, 0, 0, 4 };
+  int i;
+  char **cpNames = (char **) malloc(sizeof(char*) * 4);
+  DataType *cpDt = (DataType *) malloc(sizeof(DataType) * 4);
+  int *cpSizes = (int *) malloc(sizeof(int) * 4);
+  int *cpKeys = (int *) malloc(sizeof(int));
+
+  for(i = 0; i < 4; i++)
+    {
+      cpNames[i] = (char *) malloc(2);
+      strcpy(cpNames[i], names[i]);
+    }
+  memcpy(cpDt, dt, sizeof(DataType) * 4);
+  memcpy(cpSizes, sizes, sizeof(int) * 4);
+  cpKeys[0] = 0;
+
+  return createSchema(4, cpNames, cpDt, cpSizes, 1, cpKeys);
+}
+
+// ************************************************************
+Record *
+testRecord (Schema *schema, int a, char *b, int c)
+{
+  Record *result;
+  Value *value;
+
+  TEST_CHECK(createRecord(&result, schema));
+
+  MAKE_VALUE(value, DT_INT, a);
+  TEST_CHECK(setAttr(result, schema, 0, value));
+  freeVal(value);
+
+  MAKE_STRING_VALUE(value, b);
+  TEST_CHECK(setAttr(result, schema, 1, value));
+  freeVal(value);
+
+  MAKE_VALUE(value, DT_INT, c);
+  TEST_CHECK(setAttr(result, schema, 2, value));
+  freeVal(value);
+
+  return result;
+}